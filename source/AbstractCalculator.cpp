@@ -27,8 +27,39 @@
 #include "Units.h"
 
 #include <QDebug>
+#include <algorithm>
 #include <cmath>
 
+namespace {
+//! Product of two complex numbers given by their parts
+inline void complexMul(double aRe, double aIm, double bRe, double bIm,
+                       double &re, double &im) {
+  re = aRe * bRe - aIm * bIm;
+  im = aRe * bIm + aIm * bRe;
+}
+
+//! Principal square root of a complex number given by its parts
+inline void complexSqrt(double x, double y, double &re, double &im) {
+  const double t = std::sqrt(0.5 * (std::sqrt(x * x + y * y) + std::abs(x)));
+  // Both branches are evaluated so that a loop has no control flow
+  const double u = y / (2 * t);
+  re = x >= 0 ? t : std::abs(u);
+  im = x >= 0 ? u : std::copysign(t, y);
+}
+
+//! Phase terms exp(i k* z) and exp(-i k* z) of a complex wave number
+inline void wavePhase(double kRe, double kIm, double z, double &posRe,
+                      double &posIm, double &negRe, double &negIm) {
+  const double scale = std::exp(-kIm * z);
+  const double cosTerm = std::cos(kRe * z);
+  const double sinTerm = std::sin(kRe * z);
+  posRe = scale * cosTerm;
+  posIm = scale * sinTerm;
+  negRe = cosTerm / scale;
+  negIm = -sinTerm / scale;
+}
+} // namespace
+
 AbstractCalculator::AbstractCalculator(QObject *parent)
     : QObject(parent), _status(CalculationStatus::NotRun) {
   _site = nullptr;
@@ -81,18 +112,11 @@ void AbstractCalculator::init(AbstractMotion *motion, SoilProfile *site) {
   }
 
   if (siteChanged || motionChanged) {
-    // Size the vectors
-    _shearMod.resize(_nsl + 1);
-    _waveA.resize(_nsl + 1);
-    _waveB.resize(_nsl + 1);
-    _waveNum.resize(_nsl + 1);
-
-    for (int i = 0; i <= _nsl; ++i) {
-      _shearMod[i].resize(_nf);
-      _waveA[i].resize(_nf);
-      _waveB[i].resize(_nf);
-      _waveNum[i].resize(_nf);
-    }
+    // Size the matrices
+    _shearMod.resize(_nsl + 1, _nf);
+    _waveA.resize(_nsl + 1, _nf);
+    _waveB.resize(_nsl + 1, _nf);
+    _waveNum.resize(_nsl + 1, _nf);
   }
 }
 
@@ -109,61 +133,121 @@ auto AbstractCalculator::calcCompShearMod(const double shearMod,
   return shearMod * std::complex<double>(1.0 - damping * damping, 2 * damping);
 }
 
-auto AbstractCalculator::calcWaves() -> bool {
-  std::complex<double> cImped;
-  std::complex<double> cTerm;
+void AbstractCalculator::setCompShearMod(int index,
+                                         const QVector<double> &shearMods,
+                                         const QVector<double> &dampings) {
+  Q_ASSERT(shearMods.size() == _nf && dampings.size() == _nf);
+
+  // Same as calcCompShearMod, but written out on the real and imaginary parts
+  // so that the loop can be vectorized
+  const double *g = shearMods.constData();
+  const double *d = dampings.constData();
+  double *gRe = _shearMod.re(index);
+  double *gIm = _shearMod.im(index);
+  for (int j = 0; j < _nf; ++j) {
+    const double damping = d[j] / 100.;
+    gRe[j] = g[j] * (1.0 - damping * damping);
+    gIm[j] = g[j] * 2 * damping;
+  }
+}
 
-  // Compute the complex wave numbers of the system
-  for (int i = 0; i <= _nsl; ++i) {
+auto AbstractCalculator::calcWaves(int firstLayer) -> bool {
+  /* The complex arithmetic is written out on the real and imaginary parts of
+   * the matrices. Each loop runs over the frequencies of a layer, which are
+   * independent and contiguous in memory. The wave number loop is
+   * vectorized by the compiler when math functions may skip setting errno
+   * (see source/CMakeLists.txt). The exp, cos, and sin of the phase terms
+   * in the wave loop remain calls to the scalar math library, so that loop
+   * is not vectorized.
+   */
+  const double *freq = _motion->freq().constData();
+
+  // Compute the complex wave numbers of the system: k* = angFreq / v*_s,
+  // where the complex shear-wave velocity is v*_s = sqrt(G* / density)
+  for (int i = firstLayer; i <= _nsl; ++i) {
     const double density_i = _site->density(i);
+    const double *gRe = _shearMod.re(i);
+    const double *gIm = _shearMod.im(i);
+    double *kRe = _waveNum.re(i);
+    double *kIm = _waveNum.im(i);
+
     for (int j = 0; j < _nf; ++j) {
-      _waveNum[i][j] =
-          _motion->angFreqAt(j) / sqrt(_shearMod[i][j] / density_i);
+      double vRe, vIm;
+      complexSqrt(gRe[j] / density_i, gIm[j] / density_i, vRe, vIm);
+
+      const double angFreq = 2 * M_PI * freq[j];
+      const double vAbs2 = vRe * vRe + vIm * vIm;
+      kRe[j] = angFreq * vRe / vAbs2;
+      kIm[j] = -angFreq * vIm / vAbs2;
     }
   }
 
-  for (int i = 0; i < _nsl; ++i) {
+  // In the top surface layer, the up-going and down-going waves have an
+  // amplitude of 1 as they are completely reflected at the surface.
+  _waveA.fill(0, 1.0);
+  _waveB.fill(0, 1.0);
+
+  // The waves in a layer depend on the properties of the layer above
+  for (int i = std::max(0, firstLayer - 1); i < _nsl; ++i) {
     const double thickness = _site->subLayers().at(i).thickness();
+
+    const double *kRe = _waveNum.re(i);
+    const double *kIm = _waveNum.im(i);
+    const double *gRe = _shearMod.re(i);
+    const double *gIm = _shearMod.im(i);
+    const double *kReBelow = _waveNum.re(i + 1);
+    const double *kImBelow = _waveNum.im(i + 1);
+    const double *gReBelow = _shearMod.re(i + 1);
+    const double *gImBelow = _shearMod.im(i + 1);
+
+    const double *aRe = _waveA.re(i);
+    const double *aIm = _waveA.im(i);
+    const double *bRe = _waveB.re(i);
+    const double *bIm = _waveB.im(i);
+    double *aReBelow = _waveA.re(i + 1);
+    double *aImBelow = _waveA.im(i + 1);
+    double *bReBelow = _waveB.re(i + 1);
+    double *bImBelow = _waveB.im(i + 1);
+
     for (int j = 0; j < _nf; ++j) {
-      // In the top surface layer, the up-going and down-going waves have
-      // an amplitude of 1 as they are completely reflected at the
-      // surface.
-      if (i == 0) {
-        _waveA[i][j] = 1.0;
-        _waveB[i][j] = 1.0;
-      }
+      // Complex impedence: (k*_i G*_i) / (k*_i+1 G*_i+1)
+      double numRe, numIm, denRe, denIm;
+      complexMul(kRe[j], kIm[j], gRe[j], gIm[j], numRe, numIm);
+      complexMul(kReBelow[j], kImBelow[j], gReBelow[j], gImBelow[j], denRe,
+                 denIm);
+      const double denAbs2 = denRe * denRe + denIm * denIm;
+      const double cImpedRe = (numRe * denRe + numIm * denIm) / denAbs2;
+      const double cImpedIm = (numIm * denRe - numRe * denIm) / denAbs2;
+
+      // exp(i k* h) and exp(-i k* h) -- uses full layer height
+      double posRe, posIm, negRe, negIm;
+      wavePhase(kRe[j], kIm[j], thickness, posRe, posIm, negRe, negIm);
+
+      // A exp(i k* h) and B exp(-i k* h)
+      double aeRe, aeIm, bfRe, bfIm;
+      complexMul(aRe[j], aIm[j], posRe, posIm, aeRe, aeIm);
+      complexMul(bRe[j], bIm[j], negRe, negIm, bfRe, bfIm);
+
+      // Multiply by (1 + cImped) and (1 - cImped)
+      double aePlusRe, aePlusIm, aeMinusRe, aeMinusIm;
+      double bfPlusRe, bfPlusIm, bfMinusRe, bfMinusIm;
+      complexMul(aeRe, aeIm, 1.0 + cImpedRe, cImpedIm, aePlusRe, aePlusIm);
+      complexMul(aeRe, aeIm, 1.0 - cImpedRe, -cImpedIm, aeMinusRe, aeMinusIm);
+      complexMul(bfRe, bfIm, 1.0 + cImpedRe, cImpedIm, bfPlusRe, bfPlusIm);
+      complexMul(bfRe, bfIm, 1.0 - cImpedRe, -cImpedIm, bfMinusRe, bfMinusIm);
+
+      aReBelow[j] = 0.5 * (aePlusRe + bfMinusRe);
+      aImBelow[j] = 0.5 * (aePlusIm + bfMinusIm);
+      bReBelow[j] = 0.5 * (aeMinusRe + bfPlusRe);
+      bImBelow[j] = 0.5 * (aeMinusIm + bfPlusIm);
+    }
 
-      // At frequencies less than 0.000001 (zero) the amplitude of the
-      // upgoing and downgoing waves is 1.
-      if (_motion->freqAt(j) < 0.000001) {
-        _waveA[i + 1][j] = 1.0;
-        _waveB[i + 1][j] = 1.0;
-      } else {
-        // Cache complex values to avoid repeated lookups
-        const std::complex<double> &waveNum_i_j = _waveNum[i][j];
-        const std::complex<double> &waveNum_ip1_j = _waveNum[i + 1][j];
-        const std::complex<double> &shearMod_i_j = _shearMod[i][j];
-        const std::complex<double> &shearMod_ip1_j = _shearMod[i + 1][j];
-        const std::complex<double> &waveA_i_j = _waveA[i][j];
-        const std::complex<double> &waveB_i_j = _waveB[i][j];
-
-        // Complex impedence
-        cImped =
-            (waveNum_i_j * shearMod_i_j) / (waveNum_ip1_j * shearMod_ip1_j);
-
-        // Complex term to simplify equations -- uses full layer height
-        cTerm = std::complex<double>(0.0, 1.0) * waveNum_i_j * thickness;
-
-        const std::complex<double> exp_cTerm = exp(cTerm);
-        const std::complex<double> exp_neg_cTerm = exp(-cTerm);
-        const std::complex<double> one_plus_cImped = 1.0 + cImped;
-        const std::complex<double> one_minus_cImped = 1.0 - cImped;
-
-        _waveA[i + 1][j] = 0.5 * waveA_i_j * one_plus_cImped * exp_cTerm +
-                           0.5 * waveB_i_j * one_minus_cImped * exp_neg_cTerm;
-
-        _waveB[i + 1][j] = 0.5 * waveA_i_j * one_minus_cImped * exp_cTerm +
-                           0.5 * waveB_i_j * one_plus_cImped * exp_neg_cTerm;
+    // At frequencies less than 0.000001 (zero) the amplitude of the
+    // upgoing and downgoing waves is 1.
+    for (int j = 0; j < _nf; ++j) {
+      if (freq[j] < 0.000001) {
+        _waveA.set(i + 1, j, 1.0);
+        _waveB.set(i + 1, j, 1.0);
       }
     }
   }
@@ -174,6 +258,77 @@ auto AbstractCalculator::calcStrainTf(const Location &inLocation,
                                       const AbstractMotion::Type inputType,
                                       const Location &outLocation) const
     -> QVector<std::complex<double>> {
+  QVector<std::complex<double>> tf;
+  strainTf(waves(inLocation, inputType), outLocation, tf);
+  return tf;
+}
+
+auto AbstractCalculator::calcStressTf(const Location &inLocation,
+                                      const AbstractMotion::Type inputType,
+                                      const Location &outLocation) const
+    -> QVector<std::complex<double>> {
+  QVector<std::complex<double>> tf;
+  strainTf(waves(inLocation, inputType), outLocation, tf);
+  strainToStressTf(outLocation, tf);
+  return tf;
+}
+
+auto AbstractCalculator::calcAccelTf(
+    const Location &inLocation, const AbstractMotion::Type inputType,
+    const Location &outLocation, const AbstractMotion::Type outputType) const
+    -> const QVector<std::complex<double>> {
+  QVector<std::complex<double>> tf;
+  accelTf(waves(inLocation, inputType), outLocation, outputType, tf);
+  return tf;
+}
+
+void AbstractCalculator::calcAccelTfs(
+    const Location &inLocation, const AbstractMotion::Type inputType,
+    const QVector<Location> &outLocations,
+    const QVector<AbstractMotion::Type> &outputTypes,
+    QVector<QVector<std::complex<double>>> &tfs) const {
+  Q_ASSERT(outLocations.size() == outputTypes.size());
+
+  const QVector<std::complex<double>> inWaves = waves(inLocation, inputType);
+
+  tfs.resize(outLocations.size());
+  for (int i = 0; i < outLocations.size(); ++i)
+    accelTf(inWaves, outLocations.at(i), outputTypes.at(i), tfs[i]);
+}
+
+void AbstractCalculator::calcStrainTfs(
+    const Location &inLocation, const AbstractMotion::Type inputType,
+    const QVector<Location> &outLocations,
+    QVector<QVector<std::complex<double>>> &tfs) const {
+  const QVector<std::complex<double>> inWaves = waves(inLocation, inputType);
+
+  tfs.resize(outLocations.size());
+  for (int i = 0; i < outLocations.size(); ++i)
+    strainTf(inWaves, outLocations.at(i), tfs[i]);
+}
+
+auto AbstractCalculator::tfScratch(int index)
+    -> QVector<QVector<std::complex<double>>> & {
+  Q_ASSERT(0 <= index && index < tfScratchCount);
+  return _tfScratch[index];
+}
+
+void AbstractCalculator::accelTf(const QVector<std::complex<double>> &inWaves,
+                                 const Location &outLocation,
+                                 const AbstractMotion::Type outputType,
+                                 QVector<std::complex<double>> &tf) const {
+  // The output waves are computed in place
+  waves(outLocation, outputType, tf);
+
+  for (int i = 0; i < _nf; i++) {
+    const std::complex<double> value = tf.at(i) / inWaves.at(i);
+    tf[i] = std::isnan(std::abs(value)) ? 0. : value;
+  }
+}
+
+void AbstractCalculator::strainTf(const QVector<std::complex<double>> &inWaves,
+                                  const Location &outLocation,
+                                  QVector<std::complex<double>> &tf) const {
 
   /* The strain transfer function from the acceleration at layer n (outcrop)
   to the mid-height of layer m (within) is defined as:
@@ -198,81 +353,104 @@ auto AbstractCalculator::calcStrainTf(const Location &inLocation,
 
   */
 
-  QVector<std::complex<double>> tf(_nf);
-  std::complex<double> cTerm, numer, denom;
-  std::complex<double> value;
+  tf.resize(_nf);
 
   const int l = outLocation.layer();
   const double gravity = Units::instance()->gravity();
   const double outDepth = outLocation.depth();
   const double density_l = _site->density(l);
-  const std::complex<double> gravity_cmplx(gravity, 0.0);
-  const std::complex<double> imag_unit(0.0, 1.0);
 
-  // Strain is inversely proportional to the complex shear-wave velocity
-  for (int i = 0; i < tf.size(); ++i) {
-    cTerm = imag_unit * _waveNum[l][i] * outDepth;
+  const double *kRe = _waveNum.re(l);
+  const double *kIm = _waveNum.im(l);
+  const double *gRe = _shearMod.re(l);
+  const double *gIm = _shearMod.im(l);
+  const double *aRe = _waveA.re(l);
+  const double *aIm = _waveA.im(l);
+  const double *bRe = _waveB.re(l);
+  const double *bIm = _waveB.im(l);
+  const std::complex<double> *in = inWaves.constData();
+  std::complex<double> *out = tf.data();
 
-    const std::complex<double> exp_cTerm = exp(cTerm);
-    const std::complex<double> exp_neg_cTerm = exp(-cTerm);
+  // Strain is inversely proportional to the complex shear-wave velocity
+  for (int i = 0; i < _nf; ++i) {
+    double posRe, posIm, negRe, negIm;
+    wavePhase(kRe[i], kIm[i], outDepth, posRe, posIm, negRe, negIm);
 
     // Compute the numerator cannot be computed using waves since it is
     // A-B. The numerator includes gravity to correct for the Vs scaling.
-    numer = gravity_cmplx *
-            (_waveA[l][i] * exp_cTerm - _waveB[l][i] * exp_neg_cTerm);
-
-    denom = sqrt(_shearMod[l][i] / density_l) * waves(i, inLocation, inputType);
-
-    value = numer / denom;
-    tf[i] = std::isnan(std::abs(value)) ? 0. : value;
+    double aeRe, aeIm, bfRe, bfIm;
+    complexMul(aRe[i], aIm[i], posRe, posIm, aeRe, aeIm);
+    complexMul(bRe[i], bIm[i], negRe, negIm, bfRe, bfIm);
+    const std::complex<double> numer(gravity * (aeRe - bfRe),
+                                     gravity * (aeIm - bfIm));
+
+    double vRe, vIm, denRe, denIm;
+    complexSqrt(gRe[i] / density_l, gIm[i] / density_l, vRe, vIm);
+    complexMul(vRe, vIm, in[i].real(), in[i].imag(), denRe, denIm);
+
+    const std::complex<double> value =
+        numer / std::complex<double>(denRe, denIm);
+    out[i] = std::isnan(std::abs(value)) ? 0. : value;
   }
-
-  return tf;
 }
 
-auto AbstractCalculator::calcStressTf(const Location &inLocation,
-                                      const AbstractMotion::Type inputType,
-                                      const Location &outLocation) const
-    -> QVector<std::complex<double>> {
-  QVector<std::complex<double>> tf =
-      calcStrainTf(inLocation, inputType, outLocation);
+void AbstractCalculator::strainToStressTf(
+    const Location &outLocation, QVector<std::complex<double>> &tf) const {
   const int l = outLocation.layer();
+  const double *gRe = _shearMod.re(l);
+  const double *gIm = _shearMod.im(l);
+  std::complex<double> *values = tf.data();
 
   for (int i = 0; i < tf.size(); ++i) {
-    tf[i] *= _shearMod.at(l).at(i);
+    double re, im;
+    complexMul(values[i].real(), values[i].imag(), gRe[i], gIm[i], re, im);
+    values[i] = {re, im};
   }
-
-  return tf;
 }
 
-auto AbstractCalculator::calcAccelTf(
-    const Location &inLocation, const AbstractMotion::Type inputType,
-    const Location &outLocation, const AbstractMotion::Type outputType) const
-    -> const QVector<std::complex<double>> {
-  QVector<std::complex<double>> tf(_nf);
-  std::complex<double> value;
-
-  for (int i = 0; i < _nf; i++) {
-    value = waves(i, outLocation, outputType) / waves(i, inLocation, inputType);
-    tf[i] = std::isnan(std::abs(value)) ? 0. : value;
-  }
-
-  return tf;
+auto AbstractCalculator::waves(const Location &location,
+                               const AbstractMotion::Type type) const
+    -> QVector<std::complex<double>> {
+  QVector<std::complex<double>> values;
+  waves(location, type, values);
+  return values;
 }
 
-auto AbstractCalculator::waves(const int freqIdx, const Location &location,
-                               const AbstractMotion::Type type) const
-    -> const std::complex<double> {
-  std::complex<double> cTerm = std::complex<double>(0., 1.) *
-                               _waveNum.at(location.layer()).at(freqIdx) *
-                               location.depth();
-
-  if (type == AbstractMotion::Within) {
-    return _waveA.at(location.layer()).at(freqIdx) * exp(cTerm) +
-           _waveB.at(location.layer()).at(freqIdx) * exp(-cTerm);
-  } else if (type == AbstractMotion::Outcrop) {
-    return 2.0 * _waveA.at(location.layer()).at(freqIdx) * exp(cTerm);
-  } else { // type == AbstractMotion::IncomingOnly
-    return _waveA.at(location.layer()).at(freqIdx) * exp(cTerm);
+void AbstractCalculator::waves(const Location &location,
+                               const AbstractMotion::Type type,
+                               QVector<std::complex<double>> &values) const {
+  values.resize(_nf);
+
+  const int l = location.layer();
+  const double depth = location.depth();
+
+  const double *kRe = _waveNum.re(l);
+  const double *kIm = _waveNum.im(l);
+  const double *aRe = _waveA.re(l);
+  const double *aIm = _waveA.im(l);
+  const double *bRe = _waveB.re(l);
+  const double *bIm = _waveB.im(l);
+  std::complex<double> *out = values.data();
+
+  for (int i = 0; i < _nf; ++i) {
+    double posRe, posIm, negRe, negIm;
+    wavePhase(kRe[i], kIm[i], depth, posRe, posIm, negRe, negIm);
+
+    // A exp(i k* z)
+    double re, im;
+    complexMul(aRe[i], aIm[i], posRe, posIm, re, im);
+
+    if (type == AbstractMotion::Within) {
+      // A exp(i k* z) + B exp(-i k* z)
+      double bfRe, bfIm;
+      complexMul(bRe[i], bIm[i], negRe, negIm, bfRe, bfIm);
+      re += bfRe;
+      im += bfIm;
+    } else if (type == AbstractMotion::Outcrop) {
+      // 2 A exp(i k* z)
+      re *= 2;
+      im *= 2;
+    }
+    out[i] = {re, im};
   }
 }
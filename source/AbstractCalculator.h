@@ -25,6 +25,7 @@
 #include <QObject>
 
 #include "AbstractMotion.h"
+#include "ComplexMatrix.h"
 
 #include <QVector>
 
@@ -48,6 +49,9 @@ enum CalculationStatus {
 class AbstractCalculator : public QObject {
   Q_OBJECT
 
+  //! The profile outputs compute their transfer functions in tfScratch()
+  friend class AbstractProfileOutput;
+
 public:
   explicit AbstractCalculator(QObject *parent = nullptr);
 
@@ -66,6 +70,13 @@ public:
   //! Perform the site response calculation
   virtual auto run(AbstractMotion *motion, SoilProfile *site) -> bool = 0;
 
+  /*! Create a new calculator with the same parameters.
+   *
+   * Used to run several calculations at the same time; the returned
+   * calculator does not share any state with this one.
+   */
+  virtual auto duplicate() const -> AbstractCalculator * = 0;
+
   //! Calculation status
   auto status() const -> CalculationStatus;
 
@@ -111,6 +122,28 @@ public:
                     const AbstractMotion::Type inputType,
                     const Location &outLocation) const
       -> QVector<std::complex<double>>;
+
+  /*! @name Batched transfer functions
+   *
+   * Compute the transfer functions for several output locations in one
+   * pass. The waves at the input location are only computed once. The
+   * transfer functions are stored in \a tfs, which is resized to one row per
+   * output location; existing rows are reused to avoid allocations.
+   */
+  //@{
+  void calcAccelTfs(const Location &inLocation,
+                    const AbstractMotion::Type inputType,
+                    const QVector<Location> &outLocations,
+                    const QVector<AbstractMotion::Type> &outputTypes,
+                    QVector<QVector<std::complex<double>>> &tfs) const;
+
+  void calcStrainTfs(const Location &inLocation,
+                     const AbstractMotion::Type inputType,
+                     const QVector<Location> &outLocations,
+                     QVector<QVector<std::complex<double>>> &tfs) const;
+
+  //@}
+
 signals:
   void wasModified();
 
@@ -125,19 +158,47 @@ protected:
   static auto calcCompShearMod(const double shearMod, const double damping)
       -> std::complex<double>;
 
+  /*! Set the complex shear modulus of a sublayer at each frequency
+   * \param index index of the sublayer
+   * \param shearMods shear modulus at each frequency
+   * \param dampings damping at each frequency -- percent
+   */
+  void setCompShearMod(int index, const QVector<double> &shearMods,
+                       const QVector<double> &dampings);
+
   /*! Compute the up-going and down-going waves
+   * \param firstLayer shallowest sublayer with modified properties. The
+   * waves above this sublayer are unchanged and are not recomputed.
    * \return if the calculation is successful
    */
-  auto calcWaves() -> bool;
+  auto calcWaves(int firstLayer = 0) -> bool;
+
+  //! Return the combined waves at all frequencies
+  auto waves(const Location &location, const AbstractMotion::Type type) const
+      -> QVector<std::complex<double>>;
 
-  /*! Return the combined waves for a given set of conditions
-   * \param freqIdx index of the frequency
+  /*! Compute the combined waves at all frequencies
    * \param location the location in the site profile
    * \param type type of motion
+   * \param values resized to the number of frequencies and set to the waves
    */
-  auto waves(const int freqIdx, const Location &location,
-             const AbstractMotion::Type type) const
-      -> const std::complex<double>;
+  void waves(const Location &location, const AbstractMotion::Type type,
+             QVector<std::complex<double>> &values) const;
+
+  //! Compute an acceleration transfer function from the input waves
+  void accelTf(const QVector<std::complex<double>> &inWaves,
+               const Location &outLocation,
+               const AbstractMotion::Type outputType,
+               QVector<std::complex<double>> &tf) const;
+
+  //! Compute a strain transfer function from the input waves
+  void strainTf(const QVector<std::complex<double>> &inWaves,
+                const Location &outLocation,
+                QVector<std::complex<double>> &tf) const;
+
+  //! Multiply a strain transfer function by the complex shear modulus
+  void strainToStressTf(const Location &outLocation,
+                        QVector<std::complex<double>> &tf) const;
 
   //! Site profile
   SoilProfile *_site;
@@ -159,25 +220,42 @@ protected:
 
   /*! @name Wave propagation parameters
    *
-   * The first dimension of the vectors are the number of soil layers, the
-   * second is the frequency.
+   * The rows of the matrices are the layers (including the bedrock), the
+   * columns are the frequencies.
    */
   //@{
   //! Complex shear modulus
-  QVector<QVector<std::complex<double>>> _shearMod;
+  ComplexMatrix _shearMod;
 
   //! Up-going wave
-  QVector<QVector<std::complex<double>>> _waveA;
+  ComplexMatrix _waveA;
 
   //! Down-going wave
-  QVector<QVector<std::complex<double>>> _waveB;
+  ComplexMatrix _waveB;
 
   //! Complex wave number
-  QVector<QVector<std::complex<double>>> _waveNum;
+  ComplexMatrix _waveNum;
   //@}
 
   //! Text log to record calculation steps
   TextLog *_textLog;
+
+private:
+  //! Number of scratch matrices provided by tfScratch()
+  static constexpr int tfScratchCount = 2;
+
+  /*! Scratch storage for the batched transfer functions.
+   *
+   * The outputs are extracted one after another on the thread of the
+   * calculator, so they can share these matrices. The rows keep their
+   * capacity between outputs and motions.
+   *
+   * \param index index of the matrix, less than tfScratchCount
+   */
+  auto tfScratch(int index) -> QVector<QVector<std::complex<double>>> &;
+
+  //! Matrices returned by tfScratch()
+  QVector<QVector<std::complex<double>>> _tfScratch[tfScratchCount];
 };
 
 #endif // ABSTRACT_CALCULATOR_H
@@ -26,20 +26,117 @@
 #include "SubLayer.h"
 #include "TextLog.h"
 
+#include <algorithm>
+#include <cmath>
+
+namespace {
+//! Number of previous iterations used in Anderson mixing
+const int andersonDepth = 3;
+
+//! Fraction of the error tolerance below which a sublayer is skipped in the
+//! incremental mode
+const double incrementalThreshold = 0.25;
+
+/*! Anderson mixing of the log strains.
+ *
+ * \param x the strains used in the current iteration
+ * \param f the residual, difference between computed and used strains
+ * \param dx changes in x over the previous iterations
+ * \param df changes in f over the previous iterations
+ * \param beta relaxation
+ * \return strains for the next iteration
+ */
+auto andersonMix(const QVector<double> &x, const QVector<double> &f,
+                 const QList<QVector<double>> &dx,
+                 const QList<QVector<double>> &df, double beta)
+    -> QVector<double> {
+  const int n = x.size();
+  const int m = df.size();
+
+  // Solve the least-squares problem min |f - dF g| with the normal equations,
+  // which are at most andersonDepth x andersonDepth. A small regularization
+  // keeps them solvable when the history is nearly linearly dependent.
+  double a[andersonDepth][andersonDepth + 1];
+  double trace = 0;
+  for (int j = 0; j < m; ++j) {
+    for (int k = 0; k < m; ++k) {
+      double sum = 0;
+      for (int i = 0; i < n; ++i)
+        sum += df.at(j).at(i) * df.at(k).at(i);
+      a[j][k] = sum;
+    }
+    double sum = 0;
+    for (int i = 0; i < n; ++i)
+      sum += df.at(j).at(i) * f.at(i);
+    a[j][m] = sum;
+    trace += a[j][j];
+  }
+  for (int j = 0; j < m; ++j)
+    a[j][j] += 1e-10 * trace + 1e-300;
+
+  // Gaussian elimination with partial pivoting
+  for (int c = 0; c < m; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < m; ++r) {
+      if (std::fabs(a[r][c]) > std::fabs(a[pivot][c]))
+        pivot = r;
+    }
+    for (int k = 0; k <= m; ++k)
+      std::swap(a[c][k], a[pivot][k]);
+    for (int r = c + 1; r < m; ++r) {
+      const double factor = a[r][c] / a[c][c];
+      for (int k = c; k <= m; ++k)
+        a[r][k] -= factor * a[c][k];
+    }
+  }
+  double gamma[andersonDepth];
+  for (int c = m - 1; c >= 0; --c) {
+    double sum = a[c][m];
+    for (int k = c + 1; k < m; ++k)
+      sum -= a[c][k] * gamma[k];
+    gamma[c] = sum / a[c][c];
+  }
+
+  QVector<double> next(n);
+  bool finite = true;
+  for (int i = 0; i < n; ++i) {
+    double value = x.at(i) + beta * f.at(i);
+    for (int j = 0; j < m; ++j)
+      value -= gamma[j] * (dx.at(j).at(i) + beta * df.at(j).at(i));
+    next[i] = value;
+    finite &= std::isfinite(value);
+  }
+
+  // Fall back to a relaxed update if the mixing failed
+  if (!finite) {
+    for (int i = 0; i < n; ++i)
+      next[i] = x.at(i) + beta * f.at(i);
+  }
+
+  return next;
+}
+} // namespace
+
 AbstractIterativeCalculator::AbstractIterativeCalculator(QObject *parent)
     : AbstractCalculator(parent), _maxIterations(10), _errorTolerance(2.),
-      _name("Calculator") {}
+      _iterationMethod(FixedPoint), _relaxation(1.), _useWarmStart(false),
+      _incremental(false), _iterationCount(0), _name("Calculator") {}
+
+auto AbstractIterativeCalculator::iterationMethodList() -> QStringList {
+  return {tr("Fixed point"), tr("Anderson acceleration")};
+}
 
 auto AbstractIterativeCalculator::run(AbstractMotion *motion, SoilProfile *site)
     -> bool {
   init(motion, site);
   _okToContinue = true;
   _status = CalculationStatus::NotRun;
+  _iterationCount = 0;
 
   // Compute the bedrock properties -- these do not change during the process.
   // The shear modulus is constant over the frequency range.
-  _shearMod[_nsl].fill(calcCompShearMod(_site->bedrock()->shearMod(),
-                                        _site->bedrock()->damping() / 100.));
+  _shearMod.fill(_nsl, calcCompShearMod(_site->bedrock()->shearMod(),
+                                         _site->bedrock()->damping() / 100.));
 
   estimateInitialStrains();
 
@@ -51,7 +148,22 @@ auto AbstractIterativeCalculator::run(AbstractMotion *motion, SoilProfile *site)
   // Initialize the loop control variables
   int iter = 0;
   double maxError = 0;
-  QVector<std::complex<double>> strainTf;
+  QVector<std::complex<double>> tf;
+
+  // The strains are only mixed if requested and supported by the calculator.
+  // The mixing is done in log space as the strains span orders of magnitude.
+  const bool mixStrains =
+      canAccelerate() && (_iterationMethod == Anderson || _relaxation < 1.);
+  // Log strains used in the current iteration, and the history of changes
+  QVector<double> input;
+  QVector<double> prevInput;
+  QVector<double> residual;
+  QList<QVector<double>> inputChanges;
+  QList<QVector<double>> residualChanges;
+
+  // Sublayers that are skipped in the current iteration. These are only used
+  // in the incremental mode without mixing, as mixing changes every sublayer.
+  QVector<bool> skipped(_nsl, false);
 
   // While the error in the properties is greater than the tolerable limit
   // and the number of iterations is under the maximum compute the strain
@@ -62,22 +174,27 @@ auto AbstractIterativeCalculator::run(AbstractMotion *motion, SoilProfile *site)
       _status = CanceledByUser;
       return false;
     }
-    // Compute the upgoing and downgoing waves
-    if (!calcWaves()) {
+    // Compute the upgoing and downgoing waves. The properties only change in
+    // the sublayers that are not skipped.
+    if (!calcWaves(std::max(0, skipped.indexOf(false)))) {
       _status = WavePropagationError;
       return false;
     }
-    // Compute the strain in each of the layers
+    // Compute the strain in each of the layers. The waves at the input
+    // location are the same for all of the layers.
+    const QVector<std::complex<double>> inWaves =
+        waves(_site->inputLocation(), _motion->type());
     for (int i = 0; i < _nsl; ++i) {
-      strainTf =
-          calcStrainTf(_site->inputLocation(), _motion->type(),
-                       Location(i, _site->subLayers().at(i).thickness() / 2));
-      // Update the soil layer with the new strain -- only changes the complex
-      // shear modulus
-      if (!updateSubLayer(i, strainTf)) {
-        _textLog->append(tr("\t\tStrain limit exceeded!"));
-        _status = StrainLimitExceeded;
-        return false;
+      if (!skipped.at(i)) {
+        strainTf(inWaves,
+                 Location(i, _site->subLayers().at(i).thickness() / 2), tf);
+        // Update the soil layer with the new strain -- only changes the
+        // complex shear modulus
+        if (!updateSubLayer(i, tf)) {
+          _textLog->append(tr("\t\tStrain limit exceeded!"));
+          _status = StrainLimitExceeded;
+          return false;
+        }
       }
       // Save the error for the first layer or if the error within the layer is
       // larger than the previously saved max
@@ -91,6 +208,95 @@ auto AbstractIterativeCalculator::run(AbstractMotion *motion, SoilProfile *site)
       }
     }
 
+    // Compute the strains used for the next iteration. Mixing is skipped
+    // once converged and in the last allowed iteration, so that the final
+    // properties are always compatible with the computed strains.
+    if (mixStrains && maxError > _errorTolerance &&
+        iter + 1 < _maxIterations) {
+      QVector<double> computed(_nsl);
+      for (int i = 0; i < _nsl; ++i) {
+        computed[i] = log(_site->subLayers().at(i).effStrain());
+      }
+
+      if (input.isEmpty()) {
+        // The initial properties are not based on an effective strain, so the
+        // first update uses the computed strains.
+        input = computed;
+      } else {
+        QVector<double> nextResidual(_nsl);
+        for (int i = 0; i < _nsl; ++i) {
+          nextResidual[i] = computed.at(i) - input.at(i);
+        }
+
+        QVector<double> next;
+        if (_iterationMethod == Anderson) {
+          if (!residual.isEmpty()) {
+            QVector<double> dx(_nsl);
+            QVector<double> df(_nsl);
+            for (int i = 0; i < _nsl; ++i) {
+              dx[i] = input.at(i) - prevInput.at(i);
+              df[i] = nextResidual.at(i) - residual.at(i);
+            }
+            inputChanges << dx;
+            residualChanges << df;
+
+            // If the residual grew, the older history is likely not
+            // representative of the current state and is discarded.
+            double norm = 0;
+            double prevNorm = 0;
+            for (int i = 0; i < _nsl; ++i) {
+              norm += nextResidual.at(i) * nextResidual.at(i);
+              prevNorm += residual.at(i) * residual.at(i);
+            }
+            const int depth = (norm > prevNorm) ? 1 : andersonDepth;
+            while (inputChanges.size() > depth) {
+              inputChanges.removeFirst();
+              residualChanges.removeFirst();
+            }
+          }
+          next = andersonMix(input, nextResidual, inputChanges,
+                             residualChanges, _relaxation);
+        } else {
+          next.resize(_nsl);
+          for (int i = 0; i < _nsl; ++i) {
+            next[i] = input.at(i) + _relaxation * nextResidual.at(i);
+          }
+        }
+
+        // The mixed strains are not bounded, and may exceed the strain
+        // limit of the curves. Such a sublayer uses its computed strain
+        // instead, and the history is discarded as it no longer describes
+        // the steps that were taken.
+        bool limited = false;
+        for (int i = 0; i < _nsl; ++i) {
+          const double strainLimit =
+              _site->subLayers()[i].soilLayer()->strainLimit();
+          if (!(exp(next.at(i)) <= strainLimit)) {
+            next[i] = computed.at(i);
+            limited = true;
+          }
+        }
+
+        for (int i = 0; i < _nsl; ++i) {
+          if (!applyStrain(i, exp(next.at(i)))) {
+            _textLog->append(tr("\t\tStrain limit exceeded!"));
+            _status = StrainLimitExceeded;
+            return false;
+          }
+        }
+
+        prevInput = input;
+        residual = nextResidual;
+        input = next;
+
+        if (limited) {
+          residual.clear();
+          inputChanges.clear();
+          residualChanges.clear();
+        }
+      }
+    }
+
     // Print information regarding the iteration
     if (_textLog->level() > TextLog::Low) {
       _textLog->append(tr("\t\t\tIteration: %1 Maximum Error: %2 %")
@@ -102,8 +308,30 @@ auto AbstractIterativeCalculator::run(AbstractMotion *motion, SoilProfile *site)
     }
     // Step the iteration
     ++iter;
+    ++_iterationCount;
+
+    // In the incremental mode the sublayers with small changes are skipped
+    // until the other sublayers converge. Convergence is then checked with
+    // all of the sublayers. The last allowed iteration always includes all
+    // of the sublayers, so that convergence is never reported from a partial
+    // iteration.
+    const bool partial = skipped.contains(true);
+    if (_incremental && !mixStrains) {
+      const bool lastIteration = iter + 1 >= _maxIterations;
+      for (int i = 0; i < _nsl; ++i) {
+        skipped[i] =
+            !lastIteration && maxError > _errorTolerance &&
+            _site->subLayers().at(i).error() <
+                incrementalThreshold * _errorTolerance;
+      }
+    }
 
-  } while ((maxError > _errorTolerance) && (iter < _maxIterations));
+    if (partial && maxError <= _errorTolerance &&
+        _textLog->level() > TextLog::Low) {
+      _textLog->append(tr("\t\t\tChecking convergence of all sublayers."));
+    }
+  } while ((maxError > _errorTolerance || partial) &&
+           (iter < _maxIterations));
 
   if ((iter == _maxIterations) && (maxError > _errorTolerance)) {
     _textLog->append(tr("\t\t\t!! -- Maximum number of iterations reached "
@@ -118,6 +346,16 @@ auto AbstractIterativeCalculator::run(AbstractMotion *motion, SoilProfile *site)
   return true;
 }
 
+void AbstractIterativeCalculator::copyIterativeSettings(
+    AbstractIterativeCalculator *calc) const {
+  calc->_maxIterations = _maxIterations;
+  calc->_errorTolerance = _errorTolerance;
+  calc->_iterationMethod = _iterationMethod;
+  calc->_relaxation = _relaxation;
+  calc->_useWarmStart = _useWarmStart;
+  calc->_incremental = _incremental;
+}
+
 auto AbstractIterativeCalculator::maxIterations() const -> int {
   return _maxIterations;
 }
@@ -144,6 +382,125 @@ void AbstractIterativeCalculator::setErrorTolerance(double errorTolerance) {
   }
 }
 
+auto AbstractIterativeCalculator::iterationMethod() const -> IterationMethod {
+  return _iterationMethod;
+}
+
+void AbstractIterativeCalculator::setIterationMethod(int iterationMethod) {
+  if (_iterationMethod != iterationMethod) {
+    _iterationMethod = (IterationMethod)iterationMethod;
+
+    emit iterationMethodChanged(_iterationMethod);
+    emit wasModified();
+  }
+}
+
+auto AbstractIterativeCalculator::relaxation() const -> double {
+  return _relaxation;
+}
+
+void AbstractIterativeCalculator::setRelaxation(double relaxation) {
+  if (_relaxation != relaxation) {
+    _relaxation = relaxation;
+
+    emit relaxationChanged(_relaxation);
+    emit wasModified();
+  }
+}
+
+auto AbstractIterativeCalculator::useWarmStart() const -> bool {
+  return _useWarmStart;
+}
+
+void AbstractIterativeCalculator::setUseWarmStart(bool useWarmStart) {
+  if (_useWarmStart != useWarmStart) {
+    _useWarmStart = useWarmStart;
+
+    emit useWarmStartChanged(_useWarmStart);
+    emit wasModified();
+  }
+}
+
+void AbstractIterativeCalculator::setWarmStart(const StrainProfile &profile) {
+  _warmStart = profile;
+}
+
+auto AbstractIterativeCalculator::strainProfile() const -> StrainProfile {
+  StrainProfile profile;
+  if (!_site) {
+    return profile;
+  }
+
+  for (const SubLayer &sl : _site->subLayers()) {
+    profile.depths << sl.depthToMid();
+    profile.strains << sl.effStrain();
+  }
+  return profile;
+}
+
+auto AbstractIterativeCalculator::iterationCount() const -> int {
+  return _iterationCount;
+}
+
+auto AbstractIterativeCalculator::applyWarmStart() -> bool {
+  const QVector<double> &depths = _warmStart.depths;
+  const QVector<double> &strains = _warmStart.strains;
+  if (!_useWarmStart || depths.isEmpty() || depths.size() != strains.size()) {
+    return false;
+  }
+
+  if (_textLog->level() > TextLog::Low) {
+    _textLog->append(tr("\t\tStarting from the strains of a previous "
+                        "calculation."));
+  }
+
+  int j = 0;
+  for (SubLayer &sl : _site->subLayers()) {
+    const double depth = sl.depthToMid();
+    // Both the sublayers and the profile are ordered by depth
+    while (j < depths.size() - 1 && depths.at(j + 1) < depth) {
+      ++j;
+    }
+
+    double strain;
+    if (depth <= depths.first()) {
+      strain = strains.first();
+    } else if (depth >= depths.last()) {
+      strain = strains.last();
+    } else {
+      const double t =
+          (depth - depths.at(j)) / (depths.at(j + 1) - depths.at(j));
+      strain = (1 - t) * strains.at(j) + t * strains.at(j + 1);
+    }
+    sl.setInitialStrain(strain);
+  }
+  return true;
+}
+
+auto AbstractIterativeCalculator::incremental() const -> bool {
+  return _incremental;
+}
+
+void AbstractIterativeCalculator::setIncremental(bool incremental) {
+  if (_incremental != incremental) {
+    _incremental = incremental;
+
+    emit incrementalChanged(_incremental);
+    emit wasModified();
+  }
+}
+
+auto AbstractIterativeCalculator::canAccelerate() const -> bool {
+  return false;
+}
+
+auto AbstractIterativeCalculator::applyStrain(int index, double effStrain)
+    -> bool {
+  Q_UNUSED(index);
+  Q_UNUSED(effStrain);
+  return false;
+}
+
 auto AbstractIterativeCalculator::relError(double value, double reference)
     -> double {
   if (reference == 0.)
@@ -172,20 +529,30 @@ auto AbstractIterativeCalculator::maxError(const QVector<double> &maxStrain)
 void AbstractIterativeCalculator::fromJson(const QJsonObject &json) {
   _maxIterations = json["maxIterations"].toInt();
   _errorTolerance = json["errorTolerance"].toDouble();
+  _iterationMethod = (IterationMethod)json["iterationMethod"].toInt();
+  _relaxation = json["relaxation"].toDouble(1.);
+  _useWarmStart = json["useWarmStart"].toBool(false);
+  _incremental = json["incremental"].toBool(false);
 }
 
 auto AbstractIterativeCalculator::toJson() const -> QJsonObject {
   QJsonObject json;
   json["maxIterations"] = _maxIterations;
   json["errorTolerance"] = _errorTolerance;
+  json["iterationMethod"] = (int)_iterationMethod;
+  json["relaxation"] = _relaxation;
+  json["useWarmStart"] = _useWarmStart;
+  json["incremental"] = _incremental;
   return json;
 }
 
 auto operator<<(QDataStream &out, const AbstractIterativeCalculator *aic)
     -> QDataStream & {
-  out << (quint8)1;
+  out << (quint8)4;
 
   out << aic->_maxIterations << aic->_errorTolerance;
+  out << (qint32)aic->_iterationMethod << aic->_relaxation;
+  out << aic->_useWarmStart << aic->_incremental;
 
   return out;
 }
@@ -197,5 +564,20 @@ auto operator>>(QDataStream &in, AbstractIterativeCalculator *aic)
 
   in >> aic->_maxIterations >> aic->_errorTolerance;
 
+  if (ver > 1) {
+    qint32 iterationMethod;
+    in >> iterationMethod >> aic->_relaxation;
+    aic->_iterationMethod =
+        (AbstractIterativeCalculator::IterationMethod)iterationMethod;
+  }
+
+  if (ver > 2) {
+    in >> aic->_useWarmStart;
+  }
+
+  if (ver > 3) {
+    in >> aic->_incremental;
+  }
+
   return in;
 }
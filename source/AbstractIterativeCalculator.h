@@ -26,6 +26,7 @@
 
 #include <QDataStream>
 #include <QJsonObject>
+#include <QStringList>
 
 class AbstractIterativeCalculator : public AbstractCalculator {
   Q_OBJECT
@@ -39,11 +40,41 @@ class AbstractIterativeCalculator : public AbstractCalculator {
 public:
   explicit AbstractIterativeCalculator(QObject *parent = nullptr);
 
+  //! Method used to update the strains between iterations
+  enum IterationMethod {
+    FixedPoint, //!< Use the computed strains, optionally relaxed
+    Anderson    //!< Anderson mixing of the previous strains
+  };
+
+  static auto iterationMethodList() -> QStringList;
+
+  //! Effective strains of a converged calculation used as a warm start
+  struct StrainProfile {
+    //! Depth to the middle of each sublayer
+    QVector<double> depths;
+    //! Effective strain of each sublayer -- percent
+    QVector<double> strains;
+  };
+
   //! Perform the site response calculation
   virtual auto run(AbstractMotion *motion, SoilProfile *site) -> bool;
 
   auto maxIterations() const -> int;
   auto errorTolerance() const -> double;
+  auto iterationMethod() const -> IterationMethod;
+  auto relaxation() const -> double;
+  auto useWarmStart() const -> bool;
+  auto incremental() const -> bool;
+
+  //! Strains used to start the next run if the warm start is used
+  void setWarmStart(const StrainProfile &profile);
+
+  //! Strain profile of the last run
+  auto strainProfile() const -> StrainProfile;
+
+  //! Number of iterations used in the last run, including those used to
+  //! estimate the initial strains
+  auto iterationCount() const -> int;
 
   void fromJson(const QJsonObject &json);
   auto toJson() const -> QJsonObject;
@@ -51,10 +82,18 @@ public:
 signals:
   void maxIterationsChanged(int maxIterations);
   void errorToleranceChanged(double errorTolerance);
+  void iterationMethodChanged(int iterationMethod);
+  void relaxationChanged(double relaxation);
+  void useWarmStartChanged(bool useWarmStart);
+  void incrementalChanged(bool incremental);
 
 public slots:
   void setMaxIterations(int maxIterations);
   void setErrorTolerance(double errorTolerance);
+  void setIterationMethod(int iterationMethod);
+  void setRelaxation(double relaxation);
+  void setUseWarmStart(bool useWarmStart);
+  void setIncremental(bool incremental);
 
 protected:
   //! Compute the nonlinear properties
@@ -71,12 +110,46 @@ protected:
   //! Set initial strains of the layers
   virtual void estimateInitialStrains() = 0;
 
+  /*! Set the initial strains from the warm start profile.
+   *
+   * The strains are linearly interpolated at the middle of each sublayer.
+   * \return true if the warm start was applied
+   */
+  auto applyWarmStart() -> bool;
+
+  //! If the properties can be set from an effective strain with applyStrain
+  virtual auto canAccelerate() const -> bool;
+
+  //! Set the properties of a sublayer from an effective strain
+  virtual auto applyStrain(int index, double effStrain) -> bool;
+
+  //! Copy the settings of the iterative loop, used by duplicate()
+  void copyIterativeSettings(AbstractIterativeCalculator *calc) const;
+
   //! Maximum number of iterations in the equivalent linear loop
   qint32 _maxIterations;
 
   //! Error tolerance of the equivalent linear loop -- percent
   double _errorTolerance;
 
+  //! Method used to update the strains between iterations
+  IterationMethod _iterationMethod;
+
+  //! Fraction of the strain update that is applied, between 0 and 1
+  double _relaxation;
+
+  //! If the iteration starts from the strains of a previous calculation
+  bool _useWarmStart;
+
+  //! If sublayers with small changes are skipped until the others converge
+  bool _incremental;
+
+  //! Strains used to start the iteration, empty for a cold start
+  StrainProfile _warmStart;
+
+  //! Number of iterations used in the last run
+  int _iterationCount;
+
   //! Previous maximum strain
   QVector<double> _prevMaxStrain;
 
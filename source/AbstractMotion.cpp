@@ -27,6 +27,7 @@
 
 #include <QDataStream>
 #include <QDebug>
+#include <QMutexLocker>
 
 #include <gsl/gsl_math.h>
 
@@ -40,6 +41,7 @@ AbstractMotion::AbstractMotion(QObject *parent) : MyAbstractTableModel(parent) {
   // Default characteristics of the response spectrum
   _respSpec->setDamping(5.0);
   _respSpec->setPeriod(Dimension::logSpace(0.01, 5, 60));
+  _respSpecIsStale = false;
 
   connect(_respSpec, &ResponseSpectrum::wasModified, this,
           [this]() { setModified(); });
@@ -127,7 +129,27 @@ auto AbstractMotion::enabled() const -> bool { return _enabled; }
 
 void AbstractMotion::setEnabled(bool enabled) { _enabled = enabled; }
 
-auto AbstractMotion::respSpec() -> ResponseSpectrum * { return _respSpec; }
+auto AbstractMotion::respSpec() -> ResponseSpectrum * {
+  if (_respSpecIsStale)
+    setRespSpecSa(calculateRespSpec());
+
+  return _respSpec;
+}
+
+auto AbstractMotion::respSpecIsStale() const -> bool {
+  return _respSpecIsStale;
+}
+
+auto AbstractMotion::calculateRespSpec() -> QVector<double> {
+  return computeSa(_respSpec->period(), _respSpec->damping());
+}
+
+void AbstractMotion::setRespSpecSa(const QVector<double> &sa) {
+  _respSpecIsStale = false;
+  _respSpec->setSa(sa);
+}
+
+void AbstractMotion::invalidateRespSpec() { _respSpecIsStale = true; }
 
 auto AbstractMotion::pga() const -> double { return _pga; }
 
@@ -182,6 +204,42 @@ auto AbstractMotion::calcSdofTf(const double period, const double damping) const
   return tf;
 }
 
+auto AbstractMotion::sdofTfBank(const QVector<double> &period,
+                                double damping) const
+    -> QSharedPointer<const SdofTfBank> {
+  // Typically only the output and motion response spectra are requested, so
+  // a handful of entries is enough.
+  const int maxEntries = 4;
+
+  QMutexLocker locker(&_sdofTfCacheMutex);
+  for (int i = 0; i < _sdofTfCache.size(); ++i) {
+    const SdofTfCacheEntry &entry = _sdofTfCache.at(i);
+    if (entry.damping == damping && entry.period == period &&
+        entry.freq == freq()) {
+      // Move to the front so that it is evicted last
+      _sdofTfCache.move(i, 0);
+      return _sdofTfCache.first().bank;
+    }
+  }
+
+  auto *bank = new SdofTfBank;
+  bank->reserve(period.size());
+  for (const double p : period)
+    bank->append(calcSdofTf(p, damping));
+
+  SdofTfCacheEntry entry;
+  entry.freq = freq();
+  entry.period = period;
+  entry.damping = damping;
+  entry.bank = QSharedPointer<const SdofTfBank>(bank);
+
+  _sdofTfCache.prepend(entry);
+  while (_sdofTfCache.size() > maxEntries)
+    _sdofTfCache.removeLast();
+
+  return entry.bank;
+}
+
 void AbstractMotion::setPga(double pga) {
   _pga = pga;
   emit pgaChanged(_pga);
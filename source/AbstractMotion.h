@@ -28,6 +28,9 @@ class ResponseSpectrum;
 
 #include <QDataStream>
 #include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
 #include <QString>
 #include <QStringList>
 #include <QVector>
@@ -63,9 +66,22 @@ public:
   auto enabled() const -> bool;
   void setEnabled(bool enabled);
 
-  //! A reference to the response spectrum
+  //! A reference to the response spectrum, which is computed on first access
   auto respSpec() -> ResponseSpectrum *;
 
+  //! If the response spectrum is computed on the next access
+  auto respSpecIsStale() const -> bool;
+
+  /*! Compute the spectral acceleration of the response spectrum.
+   *
+   * The motion is not modified, so the spectra of different motions may be
+   * computed at the same time. The result is applied with setRespSpecSa().
+   */
+  auto calculateRespSpec() -> QVector<double>;
+
+  //! Set the spectral acceleration of the response spectrum
+  virtual void setRespSpecSa(const QVector<double> &sa);
+
   //! A reference to the frequency
   virtual auto freq() const -> const QVector<double> & = 0;
 
@@ -165,6 +181,24 @@ protected:
   auto calcSdofTf(const double period, double damping) const
       -> QVector<std::complex<double>>;
 
+  //! Transfer functions of a set of oscillators, one for each period
+  using SdofTfBank = QVector<QVector<std::complex<double>>>;
+
+  /*! Transfer functions for single degree of freedom oscillators.
+   *
+   * The bank is computed on the first request and then shared, as long as the
+   * frequencies of the motion are unchanged. This may be called from multiple
+   * threads.
+   *
+   * \param period natural periods of the oscillators
+   * \param damping damping of the oscillators in percent
+   */
+  auto sdofTfBank(const QVector<double> &period, double damping) const
+      -> QSharedPointer<const SdofTfBank>;
+
+  //! Compute the response spectrum on the next access
+  void invalidateRespSpec();
+
   //! Set the PGA and signal that it has been changed
   void setPga(double pga);
 
@@ -193,10 +227,21 @@ protected:
   //! Response spectrum
   ResponseSpectrum *_respSpec;
 
-  //! Store if the SDOF transfer function has been computed
-  bool _sdofTfIsComputed;
+  //! If the response spectrum needs to be computed
+  bool _respSpecIsStale;
+
+  //! Cached bank of oscillator transfer functions
+  struct SdofTfCacheEntry {
+    QVector<double> freq;
+    QVector<double> period;
+    double damping;
+    QSharedPointer<const SdofTfBank> bank;
+  };
+
+  //! Recently used banks of oscillator transfer functions
+  mutable QList<SdofTfCacheEntry> _sdofTfCache;
 
-  //! The single-degree-of-freedom oscillator transfer function
-  QVector<QVector<std::complex<double>>> _sdofTf;
+  //! Guards _sdofTfCache
+  mutable QMutex _sdofTfCacheMutex;
 };
 #endif // ABSTRACT_MOTION_H_
@@ -33,31 +33,38 @@
 #include <QDir>
 #include <QFont>
 #include <QJsonArray>
+#include <QLocale>
 #include <QPen>
+#include <QSysInfo>
 
 #include <qwt_scale_engine.h>
 #include <qwt_text.h>
 
+#include <algorithm>
+#include <limits>
+
 AbstractOutput::AbstractOutput(OutputCatalog *catalog)
     : QAbstractTableModel(catalog), _catalog(catalog), _statistics(nullptr),
-      _interp(nullptr), _offset_top(0), _offset_bot(0) {
+      _interp(nullptr), _dataSiteCount(0), _offset_top(0), _offset_bot(0) {
   _exportEnabled = false;
+  _summaryOnly = false;
   _motionIndex = 0;
-  _maxSize = 0;
 }
 
 auto AbstractOutput::rowCount(const QModelIndex &parent) const -> int {
   Q_UNUSED(parent);
 
   int count;
-  if (_data.size() == 0) {
+  if (_dataSiteCount == 0) {
     // Empty data
     count = 0;
   } else {
-    if (needsTime()) {
+    if (summaryOnly()) {
+      count = _statistics->average().size();
+    } else if (needsTime()) {
       count = ref(_motionIndex).size();
     } else {
-      count = _maxSize;
+      count = _data.stride();
     }
   }
   return count;
@@ -66,6 +73,13 @@ auto AbstractOutput::rowCount(const QModelIndex &parent) const -> int {
 auto AbstractOutput::columnCount(const QModelIndex &parent) const -> int {
   Q_UNUSED(parent);
 
+  if (summaryOnly()) {
+    // Reference, average, standard deviation, and fractiles
+    return 1 + (_statistics->hasEnoughData()
+                    ? 2 + _statistics->fractileCount()
+                    : 0);
+  }
+
   int count =
       needsTime() ? (1 + siteCount()) : (1 + siteCount() * motionCount());
 
@@ -80,6 +94,19 @@ auto AbstractOutput::data(const QModelIndex &index, int role) const
   if (index.parent() != QModelIndex())
     return QVariant();
 
+  if (summaryOnly() && role == Qt::DisplayRole) {
+    switch (index.column()) {
+    case 0:
+      return ref(_motionIndex).at(index.row());
+    case 1:
+      return _statistics->average().at(index.row());
+    case 2:
+      return _statistics->stdev().at(index.row());
+    default:
+      return _statistics->fractile(index.column() - 3, index.row());
+    }
+  }
+
   int site, motion;
   columnToSiteMotion(index.column(), &site, &motion);
 
@@ -97,9 +124,9 @@ auto AbstractOutput::data(const QModelIndex &index, int role) const
                  ? QVariant(_statistics->stdev().at(index.row()))
                  : QVariant();
     } else {
-      return index.row() < _data.at(site).at(motion).size()
-                 ? QVariant(_data.at(site).at(motion).at(index.row()))
-                 : QVariant("NaN");
+      const OutputData::Row row = data(site, motion);
+      return index.row() < row.size() ? QVariant(row.at(index.row()))
+                                      : QVariant("NaN");
     }
   }
 
@@ -115,6 +142,13 @@ auto AbstractOutput::headerData(int section, Qt::Orientation orientation,
   case Qt::Horizontal:
     if (section == 0) {
       return (curveType() == Yfx) ? xLabel() : yLabel();
+    } else if (summaryOnly()) {
+      if (section == 1)
+        return _statistics->averageLabel();
+      else if (section == 2)
+        return _statistics->stdevLabel();
+      else
+        return _statistics->fractileLabel(section - 3);
     } else if (_statistics && _statistics->hasEnoughData() &&
                section == columnCount() - 2) {
       return _statistics->averageLabel();
@@ -147,32 +181,57 @@ auto AbstractOutput::headerData(int section, Qt::Orientation orientation,
   return QVariant();
 }
 
-void AbstractOutput::addData(int motion, AbstractCalculator *const calculator) {
+auto AbstractOutput::extractData(int motion,
+                                 AbstractCalculator *const calculator) const
+    -> QVector<double> {
   QVector<double> ref;
   QVector<double> data;
 
+  if (motionIndependent() && motion > 0)
+    return data;
+
   extract(calculator, ref, data);
 
   if (_interp)
     data = _interp->calculate(ref, data, this->ref(motion));
 
-  if (motion == 0)
-    _data << QList<QVector<double>>();
+  return data;
+}
 
-  if (!motionIndependent() || motion == 0)
+void AbstractOutput::addData(int motion, const QVector<double> &data) {
+  if (motion == 0) {
+    // Reserve space for all of the trials with the first row
+    if (_dataSiteCount == 0 && !summaryOnly())
+      _data.reserve(_catalog->siteCount() * rowsPerSite(), data.size());
+
+    ++_dataSiteCount;
+  }
+
+  if (!motionIndependent() || motion == 0) {
     // Save the data for the first motion or for motion depedent results
-    _data.last() << data;
+    if (!summaryOnly())
+      _data.append(data);
 
-  if (_maxSize < data.size())
-    _maxSize = data.size();
+    // Update the statistics as the data arrives
+    if (_statistics)
+      _statistics->add(data);
+  }
 }
 
-void AbstractOutput::removeLastSite() {
-  if (_data.size())
-    _data.takeLast();
+auto AbstractOutput::rowsPerSite() const -> int {
+  return motionIndependent() ? 1 : _catalog->motionCount();
 }
 
 void AbstractOutput::finalize() {
+  // The number of motions is only known once the catalog is initialized, so
+  // the rows of loaded results are checked here
+  if (_data.rowCount() != _dataSiteCount * rowsPerSite() && !summaryOnly()) {
+    qWarning() << "Discarding the results of" << name()
+               << "-- each site must have one row for each motion.";
+    _data.clear();
+    _dataSiteCount = 0;
+  }
+
   if (_statistics)
     _statistics->calculate();
 }
@@ -192,16 +251,17 @@ void AbstractOutput::plot(QwtPlot *const qwtPlot,
   // Label the axes
   labelAxes(qwtPlot);
 
-  // Create the curves
+  // Create the curves, which are not available for a summary
   int n;
   int offset;
-  for (int i = 0; i < siteCount(); ++i) {
+  const int curveSiteCount = summaryOnly() ? 0 : siteCount();
+  for (int i = 0; i < curveSiteCount; ++i) {
     for (int j = 0; j < motionCount(); ++j) {
-      const QVector<double> &x =
-          (curveType() == Yfx) ? ref(j) : _data.at(i).at(j);
+      const OutputData::Row x =
+          (curveType() == Yfx) ? OutputData::Row(ref(j)) : data(i, j);
 
-      const QVector<double> &y =
-          (curveType() == Yfx) ? _data.at(i).at(j) : ref(j);
+      const OutputData::Row y =
+          (curveType() == Yfx) ? data(i, j) : OutputData::Row(ref(j));
 
       auto *curve = new QwtPlotCurve;
       setCurveSamples(curve, x, y);
@@ -226,42 +286,29 @@ void AbstractOutput::plot(QwtPlot *const qwtPlot,
 }
 
 void AbstractOutput::exportData(const QString &path, const QString &separator,
-                                const QString &prefix) {
+                                const QString &prefix, ExportFormat format) {
   const int oldMotionIndex = _motionIndex;
 
   for (int m = 0; m < motionCount(); ++m) {
     _motionIndex = m;
-    QFile file(QDir(path).absoluteFilePath(prefix + fileName(m) + ".csv"));
+    QList<QVector<double>> buffer;
+    const QList<ExportColumn> columns = exportColumns(buffer);
+
+    const QString suffix = (format == Numpy) ? ".npy" : ".csv";
+    QFile file(QDir(path).absoluteFilePath(prefix + fileName(m) + suffix));
 
     if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
       qDebug() << "Error opening:" << file.fileName();
       return;
     }
-    QTextStream out(&file);
-
-    // Header data
-    out << "# Strata Output: " << name() << Qt::endl;
-    out << "# Project:" << _catalog->title() << Qt::endl;
-
-    // Column names
-    out << "# ";
-    const int colCount = columnCount();
-    for (int i = 0; i < colCount; ++i)
-      out << headerData(i, Qt::Horizontal, Qt::DisplayRole).toString()
-          << separator;
-
-    out << Qt::endl;
-
-    // Data
-    for (int r = 0; r < rowCount(); ++r) {
-      for (int c = 0; c < colCount; ++c) {
-        out << data(index(r, c), Qt::DisplayRole).toString();
 
-        if (c < colCount - 1)
-          out << separator;
-      }
-
-      out << Qt::endl;
+    switch (format) {
+    case Text:
+      writeText(file, separator, columns);
+      break;
+    case Numpy:
+      writeNumpy(file, columns);
+      break;
     }
 
     file.close();
@@ -274,6 +321,87 @@ void AbstractOutput::exportData(const QString &path, const QString &separator,
   _motionIndex = oldMotionIndex;
 }
 
+void AbstractOutput::writeText(QFile &file, const QString &separator,
+                               const QList<ExportColumn> &columns) const {
+  // Size of the buffer written to the file at once
+  const int bufferSize = 1 << 20;
+
+  QByteArray buffer;
+  buffer.reserve(bufferSize + 4096);
+
+  // Header data
+  buffer += "# Strata Output: " + name().toUtf8() + '\n';
+  buffer += "# Project:" + _catalog->title().toUtf8() + '\n';
+
+  // Column names
+  const QByteArray sep = separator.toUtf8();
+  buffer += "# ";
+  for (int c = 0; c < columns.size(); ++c) {
+    buffer += headerData(c, Qt::Horizontal).toString().toUtf8();
+    buffer += sep;
+  }
+  buffer += '\n';
+
+  // Data
+  const int count = rowCount();
+  for (int r = 0; r < count; ++r) {
+    for (int c = 0; c < columns.size(); ++c) {
+      const ExportColumn &column = columns.at(c);
+      if (r < column.values.size())
+        buffer += QByteArray::number(column.values.at(r), 'g',
+                                     QLocale::FloatingPointShortest);
+      else
+        buffer += column.missing;
+
+      if (c < columns.size() - 1)
+        buffer += sep;
+    }
+    buffer += '\n';
+
+    if (buffer.size() > bufferSize) {
+      file.write(buffer);
+      buffer.clear();
+    }
+  }
+
+  file.write(buffer);
+}
+
+void AbstractOutput::writeNumpy(QFile &file,
+                                const QList<ExportColumn> &columns) const {
+  const int count = rowCount();
+
+  // The columns are written one after another in Fortran order
+  QByteArray header =
+      QString("{'descr': '%1f8', 'fortran_order': True, 'shape': (%2, %3), }")
+          .arg(QSysInfo::ByteOrder == QSysInfo::LittleEndian ? '<' : '>')
+          .arg(count)
+          .arg(columns.size())
+          .toLatin1();
+
+  // Pad the header with spaces so that the data is aligned to 64 bytes. The
+  // preamble has the magic string, the version, and the header length.
+  const int preambleSize = 10;
+  const int total = preambleSize + header.size() + 1;
+  header += QByteArray((64 - total % 64) % 64, ' ');
+  header += '\n';
+
+  const quint16 headerSize = header.size();
+  file.write("\x93NUMPY\x01\x00", 8);
+  file.putChar(char(headerSize & 0xff));
+  file.putChar(char(headerSize >> 8));
+  file.write(header);
+
+  const QVector<double> nans(count, std::numeric_limits<double>::quiet_NaN());
+  for (const ExportColumn &column : columns) {
+    const int size = std::min(column.values.size(), count);
+    file.write(reinterpret_cast<const char *>(column.values.data()),
+               sizeof(double) * size);
+    file.write(reinterpret_cast<const char *>(nans.constData()),
+               sizeof(double) * (count - size));
+  }
+}
+
 void AbstractOutput::intToSiteMotion(int i, int *site, int *motion) const {
   *site = intToSite(i);
   *motion = intToMotion(i);
@@ -288,15 +416,30 @@ auto AbstractOutput::intToMotion(int i) const -> int {
 void AbstractOutput::clear() {
   beginResetModel();
   _data.clear();
+  _dataSiteCount = 0;
   _motionIndex = 0;
-  _maxSize = 0;
   endResetModel();
+
+  emit cleared();
 }
 
 auto AbstractOutput::seriesEnabled(int site, int motion) -> bool {
   return _catalog->enabledAt(site, motion);
 }
 
+auto AbstractOutput::summaryOnly() const -> bool {
+  return _summaryOnly && _statistics;
+}
+
+void AbstractOutput::setSummaryOnly(bool summaryOnly) {
+  if (_summaryOnly != summaryOnly) {
+    _summaryOnly = summaryOnly;
+
+    emit summaryOnlyChanged(_summaryOnly);
+    emit wasModified();
+  }
+}
+
 auto AbstractOutput::exportEnabled() const -> bool { return _exportEnabled; }
 
 void AbstractOutput::setExportEnabled(bool exportEnabled) {
@@ -351,8 +494,8 @@ auto AbstractOutput::curveType() const -> AbstractOutput::CurveType {
 }
 
 void AbstractOutput::setCurveSamples(QwtPlotCurve *curve,
-                                     const QVector<double> &x,
-                                     const QVector<double> &y) const {
+                                     const OutputData::Row &x,
+                                     const OutputData::Row &y) const {
   int n = std::min(x.size(), y.size());
   n -= (_offset_top + _offset_bot);
   curve->setSamples(x.data() + _offset_top, y.data() + _offset_top, n);
@@ -361,15 +504,17 @@ void AbstractOutput::setCurveSamples(QwtPlotCurve *curve,
 auto AbstractOutput::zOrder() -> int { return 20; }
 
 auto AbstractOutput::isComplete() const -> bool {
-  return (_data.size() == siteCount()) && (_data.at(0).size() == motionCount());
+  const int rowCount =
+      summaryOnly() ? _statistics->count() : _data.rowCount();
+  return (_dataSiteCount == siteCount()) &&
+         (rowCount == siteCount() * motionCount());
 }
 
-auto AbstractOutput::data(int site, int motion) const
-    -> const QVector<double> & {
-  Q_ASSERT(site < _data.size());
-  Q_ASSERT(motion < _data.at(site).size());
+auto AbstractOutput::data(int site, int motion) const -> OutputData::Row {
+  Q_ASSERT(site < _dataSiteCount);
+  Q_ASSERT(motion < rowsPerSite());
 
-  return _data.at(site).at(motion);
+  return _data.row(site * rowsPerSite() + motion);
 }
 
 auto AbstractOutput::siteIndependent() const -> bool { return false; }
@@ -403,14 +548,98 @@ void AbstractOutput::columnToSiteMotion(const int column, int *site,
   }
 }
 
+auto AbstractOutput::exportColumns(QList<QVector<double>> &buffer) const
+    -> QList<ExportColumn> {
+  QList<ExportColumn> columns;
+  columns << ExportColumn{ref(_motionIndex), QByteArray()};
+
+  if (summaryOnly()) {
+    if (!_statistics->hasEnoughData())
+      return columns;
+
+    // The fractiles are estimated at each point
+    buffer.clear();
+    for (int j = 0; j < _statistics->fractileCount(); ++j) {
+      QVector<double> fractile(_statistics->average().size());
+      for (int i = 0; i < fractile.size(); ++i)
+        fractile[i] = _statistics->fractile(j, i);
+      buffer << fractile;
+    }
+
+    columns << ExportColumn{_statistics->average(), QByteArray()}
+            << ExportColumn{_statistics->stdev(), QByteArray()};
+    for (const QVector<double> &fractile : std::as_const(buffer))
+      columns << ExportColumn{fractile, QByteArray()};
+
+    return columns;
+  }
+
+  const bool hasStats = _statistics && _statistics->hasEnoughData();
+  const int end = columnCount() - (hasStats ? 2 : 0);
+  for (int c = 1; c < end; ++c) {
+    int site, motion;
+    columnToSiteMotion(c, &site, &motion);
+    columns << ExportColumn{data(site, motion), "NaN"};
+  }
+
+  if (hasStats) {
+    columns << ExportColumn{_statistics->average(), QByteArray()}
+            << ExportColumn{_statistics->stdev(), QByteArray()};
+  }
+
+  return columns;
+}
+
+auto AbstractOutput::siteData() const -> QList<QList<QVector<double>>> {
+  QList<QList<QVector<double>>> sites;
+  const int rowCount = rowsPerSite();
+  for (int i = 0; i < _dataSiteCount; ++i) {
+    QList<QVector<double>> l;
+    for (int j = 0; j < rowCount && i * rowCount + j < _data.rowCount(); ++j)
+      l << _data.row(i * rowCount + j).toVector();
+    sites << l;
+  }
+  return sites;
+}
+
+void AbstractOutput::setSiteData(const QList<QList<QVector<double>>> &sites) {
+  _data.clear();
+  _dataSiteCount = 0;
+
+  // Every site has the same number of rows, which is then compared with the
+  // number of motions by finalize()
+  for (const QList<QVector<double>> &l : sites) {
+    if (l.size() != sites.first().size()) {
+      qWarning() << "Discarding the results of" << name()
+                 << "-- the sites have different numbers of rows.";
+      return;
+    }
+  }
+
+  for (const QList<QVector<double>> &l : sites) {
+    for (const QVector<double> &v : l)
+      _data.append(v);
+  }
+  _dataSiteCount = sites.size();
+}
+
 auto AbstractOutput::prefix() const -> const QString { return ""; }
 
 auto AbstractOutput::suffix() const -> const QString { return ""; }
 
 void AbstractOutput::fromJson(const QJsonObject &json) {
   _exportEnabled = json["exportEnabled"].toBool();
+  _summaryOnly = json["summaryOnly"].toBool();
+
+  if (summaryOnly()) {
+    _data.clear();
+    _dataSiteCount = json["siteCount"].toInt();
+    _statistics->fromJson(json["statistics"].toObject());
+    return;
+  }
 
   const QJsonArray data = json["data"].toArray();
+  QList<QList<QVector<double>>> sites;
   for (const QJsonValue &site : data) {
     QList<QVector<double>> l;
     const QJsonArray siteArray = site.toArray();
@@ -424,29 +653,31 @@ void AbstractOutput::fromJson(const QJsonObject &json) {
     }
 
     if (l.size() > 0)
-      _data << l;
+      sites << l;
   }
 
-  _maxSize = 0;
-  for (const QList<QVector<double>> &l : std::as_const(_data)) {
-    for (const QVector<double> &v : l) {
-      if (_maxSize < v.size())
-        _maxSize = v.size();
-    }
-  }
+  setSiteData(sites);
 }
 
 auto AbstractOutput::toJson() const -> QJsonObject {
   QJsonObject json;
   json["className"] = metaObject()->className();
   json["exportEnabled"] = _exportEnabled;
+  json["summaryOnly"] = _summaryOnly;
+
+  if (summaryOnly()) {
+    json["siteCount"] = _dataSiteCount;
+    json["statistics"] = _statistics->toJson();
+    return json;
+  }
 
   QJsonArray data;
-  for (const QList<QVector<double>> &l : _data) {
+  const int rowCount = rowsPerSite();
+  for (int i = 0; i < _dataSiteCount; ++i) {
     QJsonArray site;
-    for (const QVector<double> &v : l) {
+    for (int j = 0; j < rowCount && i * rowCount + j < _data.rowCount(); ++j) {
       QJsonArray motion;
-      for (const double &d : v) {
+      for (const double &d : _data.row(i * rowCount + j)) {
         motion << QJsonValue(d);
       }
       // FIXME: Need the QJV?
@@ -460,9 +691,12 @@ auto AbstractOutput::toJson() const -> QJsonObject {
 }
 
 auto operator<<(QDataStream &out, const AbstractOutput *ao) -> QDataStream & {
-  out << static_cast<quint8>(1);
+  out << static_cast<quint8>(2);
+
+  out << ao->_exportEnabled << ao->siteData() << ao->_summaryOnly;
 
-  out << ao->_exportEnabled << ao->_data;
+  if (ao->summaryOnly())
+    out << ao->_statistics;
 
   return out;
 }
@@ -471,14 +705,16 @@ auto operator>>(QDataStream &in, AbstractOutput *ao) -> QDataStream & {
   quint8 ver;
   in >> ver;
 
-  in >> ao->_exportEnabled >> ao->_data;
+  QList<QList<QVector<double>>> sites;
+  in >> ao->_exportEnabled >> sites;
 
-  // Find the maximum length of all data vectors
-  for (const QList<QVector<double>> &l : std::as_const(ao->_data)) {
-    for (const QVector<double> &v : l) {
-      if (ao->_maxSize < v.size())
-        ao->_maxSize = v.size();
-    }
+  ao->setSiteData(sites);
+
+  if (ver > 1) {
+    in >> ao->_summaryOnly;
+
+    if (ao->summaryOnly())
+      in >> ao->_statistics;
   }
 
   return in;
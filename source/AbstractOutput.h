@@ -22,8 +22,11 @@
 #ifndef ABSTRACT_OUTPUT_H
 #define ABSTRACT_OUTPUT_H
 
+#include "OutputData.h"
+
 #include <QAbstractTableModel>
 #include <QDataStream>
+#include <QFile>
 #include <QJsonObject>
 
 #include <qwt_plot.h>
@@ -47,6 +50,11 @@ public:
     Xfy,
   };
 
+  enum ExportFormat {
+    Text, //!< Delimited text with a header
+    Numpy //!< NumPy array of doubles with the columns of the table
+  };
+
   explicit AbstractOutput(OutputCatalog *catalog);
 
   virtual auto rowCount(const QModelIndex &parent = QModelIndex()) const -> int;
@@ -58,27 +66,38 @@ public:
   virtual auto headerData(int section, Qt::Orientation orientation,
                           int role = Qt::DisplayRole) const -> QVariant;
 
-  //! Add the data to the output
-  virtual void addData(int motion, AbstractCalculator *const calculator);
+  /*! Extract the data of a calculation without storing it.
+   *
+   * The output is not modified, so several calculations can be extracted at
+   * the same time. An empty vector is returned if the data is not needed,
+   * e.g. for motion independent outputs of all but the first motion.
+   */
+  auto extractData(int motion, AbstractCalculator *const calculator) const
+      -> QVector<double>;
+
+  //! Add previously extracted data to the output
+  void addData(int motion, const QVector<double> &data);
 
   //! Finalize the output by computing statistics if possible
   virtual void finalize();
 
-  //! Remove the last site from the output
-  void removeLastSite();
-
   //! Configure the plot
   virtual void plot(QwtPlot *const qwtPlot,
                     QList<QwtPlotCurve *> &curves) const;
 
-  /*! Create a text file from the data
+  /*! Create a file from the data
+   *
+   * The values are formatted directly from the stored data, so that the
+   * outputs of a catalog can be exported at the same time.
    *
    * \param path location to save the files
    * \param separator character used to separate the columns of data
    * \param prefix prefix to append to the start of filename
+   * \param format format of the file
    */
   virtual void exportData(const QString &path, const QString &separator,
-                          const QString &prefix);
+                          const QString &prefix,
+                          ExportFormat format = Text);
 
   //! Short name to identify the output
   virtual auto name() const -> QString = 0;
@@ -92,6 +111,14 @@ public:
   //! If the output is enabled for export to text file
   auto exportEnabled() const -> bool;
 
+  /*! If only the statistics of the output are kept.
+   *
+   * The data of each series is added to the running statistics and then
+   * discarded, so the memory does not depend on the number of realizations.
+   * Only outputs with statistics can keep a summary.
+   */
+  auto summaryOnly() const -> bool;
+
   //! If the series is enabled and included in the statistics
   auto seriesEnabled(int site, int motion) -> bool;
 
@@ -113,7 +140,7 @@ public:
   auto motionIndex() const -> int;
 
   //! Data for a given motion and site index
-  virtual auto data(int site, int motion) const -> const QVector<double> &;
+  virtual auto data(int site, int motion) const -> OutputData::Row;
 
   //! Reference for a given motion and site index
   virtual auto ref(int motion = 0) const -> const QVector<double> & = 0;
@@ -143,8 +170,8 @@ public:
   virtual auto curveType() const -> AbstractOutput::CurveType;
 
   //! Add data to a curve
-  void setCurveSamples(QwtPlotCurve *curve, const QVector<double> &x,
-                       const QVector<double> &y) const;
+  void setCurveSamples(QwtPlotCurve *curve, const OutputData::Row &x,
+                       const OutputData::Row &y) const;
 
   //! Z order for a data curve
   static auto zOrder() -> int;
@@ -156,11 +183,13 @@ public:
 
 signals:
   void exportEnabledChanged(bool exportEnabled);
+  void summaryOnlyChanged(bool summaryOnly);
   void wasModified();
   void cleared();
 
 public slots:
   void setExportEnabled(bool exportEnabled);
+  void setSummaryOnly(bool summaryOnly);
   void setMotionIndex(int motionIndex);
 
 protected:
@@ -198,14 +227,50 @@ protected:
   //! Convert from a table column to a site motion pair
   void columnToSiteMotion(const int column, int *site, int *motion) const;
 
+  //! Column of the table used for exporting
+  struct ExportColumn {
+    OutputData::Row values;
+
+    //! Text written after the end of the values
+    QByteArray missing;
+  };
+
+  /*! Columns of the table for the current motion index
+   *
+   * \param buffer storage for values that are computed for the export
+   */
+  auto exportColumns(QList<QVector<double>> &buffer) const
+      -> QList<ExportColumn>;
+
+  //! Write the columns as delimited text
+  void writeText(QFile &file, const QString &separator,
+                 const QList<ExportColumn> &columns) const;
+
+  //! Write the columns as a NumPy array, with NaN for missing values
+  void writeNumpy(QFile &file, const QList<ExportColumn> &columns) const;
+
   //! If the output is to be exported and saved to a text file
   bool _exportEnabled;
 
+  //! If only the statistics are kept
+  bool _summaryOnly;
+
   //! Reference the catalog the stores the reference information
   OutputCatalog *_catalog;
 
-  //! Data values
-  QList<QList<QVector<double>>> _data;
+  //! Number of rows of data stored for each site
+  auto rowsPerSite() const -> int;
+
+  //! Data nested by site and motion, as used by the saved files
+  auto siteData() const -> QList<QList<QVector<double>>>;
+  void setSiteData(const QList<QList<QVector<double>>> &sites);
+
+  //! Data values of each site and motion, with the motions of a site stored
+  //! consecutively
+  OutputData _data;
+
+  //! Number of sites with data
+  qint32 _dataSiteCount;
 
   //! Statistics of the output
   OutputStatistics *_statistics;
@@ -217,9 +282,6 @@ protected:
   //! that needs time
   qint32 _motionIndex;
 
-  //! Size of the longest output
-  qint32 _maxSize;
-
   //! Visible window for plotting from the top of the profile
   bool _offset_top;
 
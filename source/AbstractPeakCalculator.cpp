@@ -22,6 +22,8 @@
 #include "AbstractPeakCalculator.h"
 
 #include <QDebug>
+#include <QMutexLocker>
+#include <QThreadPool>
 
 #include <cmath>
 
@@ -33,20 +35,81 @@ auto AbstractPeakCalculator::limitZeroCrossings(double num) const -> double {
   return std::max(num, 1.33);
 }
 
-void AbstractPeakCalculator::initCache(const QVector<double> &freqs,
-                                       const QVector<double> &fourierAmps) {
-  _momentCache.clear();
+void AbstractPeakCalculator::updateWeights(const QVector<double> &freqs) {
+  QMutexLocker locker(&_weightsMutex);
+
+  // The frequencies of a motion are typically shared with the calculator, so
+  // first check if the data is the same.
+  if ((freqs.constData() == _freqs.constData() &&
+       freqs.size() == _freqs.size()) ||
+      freqs == _freqs) {
+    return;
+  }
+
   _freqs = freqs;
-  _squaredAmps.clear();
-  for (double fa : fourierAmps) {
-    _squaredAmps << fa * fa;
+  const int n = _freqs.size();
+
+  for (int k = 0; k < weightedMomentCount; ++k) {
+    _weights[k].resize(n);
+  }
+
+  for (int i = 0; i < n; ++i) {
+    /*
+     * Width of the trapezoids on each side of the frequency. For typical
+     * trapezoidal integration, we would divide by 2 (average), but for the
+     * moment calculation the value is multiplied by 2 at the end.
+     */
+    double width = 0;
+    if (i > 0)
+      width += std::abs(_freqs.at(i) - _freqs.at(i - 1));
+    if (i < n - 1)
+      width += std::abs(_freqs.at(i + 1) - _freqs.at(i));
+
+    const double angFreq = 2 * M_PI * _freqs.at(i);
+    double weight = width;
+    for (int k = 0; k < weightedMomentCount; ++k) {
+      _weights[k][i] = weight;
+      weight *= angFreq;
+    }
   }
 }
 
-void AbstractPeakCalculator::clearCache() {
-  _freqs.clear();
-  _squaredAmps.clear();
-  _momentCache.clear();
+auto AbstractPeakCalculator::calcMoments(
+    const QVector<double> &fourierAmps) const -> Moments {
+  const int n = _freqs.size();
+  Q_ASSERT(fourierAmps.size() >= n);
+
+  const double *amps = fourierAmps.constData();
+  const double *w0 = _weights[0].constData();
+  const double *w1 = _weights[1].constData();
+  const double *w2 = _weights[2].constData();
+
+  // Independent partial sums allow the loop to be vectorized without
+  // reordering the floating point operations.
+  constexpr int lanes = 4;
+  double m0[lanes] = {0, 0, 0, 0};
+  double m1[lanes] = {0, 0, 0, 0};
+  double m2[lanes] = {0, 0, 0, 0};
+
+  int i = 0;
+  for (; i + lanes <= n; i += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      const double sa = amps[i + l] * amps[i + l];
+      m0[l] += w0[i + l] * sa;
+      m1[l] += w1[i + l] * sa;
+      m2[l] += w2[i + l] * sa;
+    }
+  }
+  for (; i < n; ++i) {
+    const double sa = amps[i] * amps[i];
+    m0[0] += w0[i] * sa;
+    m1[0] += w1[i] * sa;
+    m2[0] += w2[i] * sa;
+  }
+
+  return {(m0[0] + m0[1]) + (m0[2] + m0[3]),
+          (m1[0] + m1[1]) + (m1[2] + m1[3]),
+          (m2[0] + m2[1]) + (m2[2] + m2[3])};
 }
 
 auto AbstractPeakCalculator::calcPeak(
@@ -56,44 +119,90 @@ auto AbstractPeakCalculator::calcPeak(
   if (freqs.isEmpty() || fourierAmps.isEmpty()) {
     return 0;
   }
-  initCache(freqs, fourierAmps);
-  double peakFactor = calcPeakFactor(duration, oscFreq, oscDamping);
+  updateWeights(freqs);
+  const Moments moments = calcMoments(fourierAmps);
+  double peakFactor = calcPeakFactor(duration, oscFreq, oscDamping, moments);
   double durationRms =
       calcDurationRms(duration, oscFreq, oscDamping, siteTransFunc);
-  double respRms = std::sqrt(getMoment(0) / durationRms);
-  clearCache();
+  double respRms = std::sqrt(moments.m0 / durationRms);
   return peakFactor * respRms;
 }
 
-auto AbstractPeakCalculator::getMoment(int power) -> double {
-  double moment = 0;
-  if (_momentCache.contains(power)) {
-    moment = _momentCache[power];
-  } else {
-    // Compute the moment
-    double left = pow(2 * M_PI * _freqs.at(0), power) * _squaredAmps.at(0);
-    double right;
-    double dFreq;
-    moment = 0;
-    for (int i = 1; i < _freqs.size(); ++i) {
-      right = pow(2 * M_PI * _freqs.at(i), power) * _squaredAmps.at(i);
-      dFreq = abs(_freqs.at(i) - _freqs.at(i - 1));
-      /*
-       * For typical trapezoidal integration, we would divide by 2 (average),
-       * but for the moment calculation the value is multiplied by 2 at the end.
-       */
-      moment += dFreq * (right + left);
-      left = right;
+auto AbstractPeakCalculator::calcPeaks(
+    double duration, const QVector<double> &freqs,
+    const QVector<double> &fourierAmps, const QVector<double> &oscFreqs,
+    double oscDamping,
+    const QVector<QVector<std::complex<double>>> &oscTransFuncs,
+    const QVector<std::complex<double>> &siteTransFunc, bool parallel)
+    -> QVector<double> {
+  Q_ASSERT(oscFreqs.size() == oscTransFuncs.size());
+
+  QVector<double> peaks(oscFreqs.size(), 0.);
+  if (freqs.isEmpty() || fourierAmps.isEmpty()) {
+    return peaks;
+  }
+  updateWeights(freqs);
+
+  // Weighted squared amplitudes. The moments of an oscillator are then the
+  // product of these with its squared gain.
+  const int n = _freqs.size();
+  QVector<double> weighted[3];
+  for (int k = 0; k < 3; ++k) {
+    weighted[k].resize(n);
+  }
+  for (int i = 0; i < n; ++i) {
+    const double sa = fourierAmps.at(i) * fourierAmps.at(i);
+    for (int k = 0; k < 3; ++k) {
+      weighted[k][i] = _weights[k].at(i) * sa;
+    }
+  }
+
+  const double *v0 = weighted[0].constData();
+  const double *v1 = weighted[1].constData();
+  const double *v2 = weighted[2].constData();
+  double *out = peaks.data();
+
+  auto compute = [&](int begin, int end) {
+    for (int p = begin; p < end; ++p) {
+      Q_ASSERT(oscTransFuncs.at(p).size() >= n);
+      const std::complex<double> *tf = oscTransFuncs.at(p).constData();
+
+      Moments moments = {0, 0, 0};
+      for (int i = 0; i < n; ++i) {
+        const double gain = std::norm(tf[i]);
+        moments.m0 += gain * v0[i];
+        moments.m1 += gain * v1[i];
+        moments.m2 += gain * v2[i];
+      }
+
+      const double oscFreq = oscFreqs.at(p);
+      const double peakFactor =
+          calcPeakFactor(duration, oscFreq, oscDamping, moments);
+      const double durationRms =
+          calcDurationRms(duration, oscFreq, oscDamping, siteTransFunc);
+      out[p] = peakFactor * std::sqrt(moments.m0 / durationRms);
     }
-    _momentCache[power] = moment;
+  };
+
+  // Number of oscillators computed by each task
+  const int chunk = 8;
+  if (parallel && peaks.size() > chunk) {
+    QThreadPool pool;
+    for (int begin = 0; begin < peaks.size(); begin += chunk) {
+      const int end = qMin(begin + chunk, int(peaks.size()));
+      pool.start([&compute, begin, end]() { compute(begin, end); });
+    }
+    pool.waitForDone();
+  } else {
+    compute(0, peaks.size());
   }
 
-  return moment;
+  return peaks;
 }
 
 auto AbstractPeakCalculator::calcDurationRms(
     double duration, double oscFreq, double oscDamping,
-    const QVector<std::complex<double>> &siteTransFunc) -> double {
+    const QVector<std::complex<double>> &siteTransFunc) const -> double {
   Q_UNUSED(oscFreq);
   Q_UNUSED(oscDamping);
   Q_UNUSED(siteTransFunc);
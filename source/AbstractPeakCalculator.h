@@ -22,7 +22,7 @@
 #ifndef ABSTRACTPEAKCALCULATOR_H
 #define ABSTRACTPEAKCALCULATOR_H
 
-#include <QMap>
+#include <QMutex>
 #include <QString>
 #include <QVector>
 
@@ -39,28 +39,83 @@ public:
                 const QVector<std::complex<double>> &siteTransFunc =
                     QVector<std::complex<double>>()) -> double;
 
+  /*! Compute the peak responses of a set of oscillators.
+   *
+   * The weighted squared amplitudes are computed once, and then the moments
+   * of each oscillator are the product with its squared gain. Each
+   * oscillator is independent, and may be computed on a separate thread.
+   *
+   * \param duration ground motion duration
+   * \param freqs frequencies of the Fourier amplitudes
+   * \param fourierAmps Fourier amplitudes, including the site response
+   * \param oscFreqs natural frequencies of the oscillators
+   * \param oscDamping damping of the oscillators in percent
+   * \param oscTransFuncs transfer functions of the oscillators
+   * \param siteTransFunc site transfer function
+   * \param parallel if the oscillators should be split across threads
+   * \return peak response of each oscillator
+   */
+  auto calcPeaks(
+      double duration, const QVector<double> &freqs,
+      const QVector<double> &fourierAmps, const QVector<double> &oscFreqs,
+      double oscDamping,
+      const QVector<QVector<std::complex<double>>> &oscTransFuncs,
+      const QVector<std::complex<double>> &siteTransFunc =
+          QVector<std::complex<double>>(),
+      bool parallel = false) -> QVector<double>;
+
   virtual auto
   calcDurationRms(double duration, double oscFreq, double oscDamping,
-                  const QVector<std::complex<double>> &siteTransFunc) -> double;
+                  const QVector<std::complex<double>> &siteTransFunc) const
+      -> double;
 
 protected:
+  //! The zeroth, first, and second spectral moments
+  struct Moments {
+    double m0;
+    double m1;
+    double m2;
+  };
+
+  //! Compute the peak factor from the spectral moments. Must be thread-safe.
   virtual auto calcPeakFactor(double duration, double oscFreq,
-                              double oscDamping) -> double = 0;
+                              double oscDamping, const Moments &moments) const
+      -> double = 0;
 
-  void initCache(const QVector<double> &freqs,
-                 const QVector<double> &fourierAmps);
-  void clearCache();
+  /*! Compute the zeroth, first, and second moments.
+   *
+   * The moments are computed together in a single pass using the
+   * precomputed weights, without modifying the calculator.
+   */
+  auto calcMoments(const QVector<double> &fourierAmps) const -> Moments;
 
-  auto getMoment(int power) -> double;
+  /*! Compute the moment weights if the frequencies have changed.
+   *
+   * The frequencies of a motion do not change during a calculation, so the
+   * weights are only written by the first of any concurrent calls and are
+   * then shared read-only.
+   */
+  void updateWeights(const QVector<double> &freqs);
 
   auto limitZeroCrossings(double) const -> double;
 
   QString _name;
 
   QVector<double> _freqs;
-  QVector<double> _squaredAmps;
 
-  QMap<int, double> _momentCache;
+  //! Number of moments with precomputed weights
+  static constexpr int weightedMomentCount = 3;
+
+  /*! Weights of the squared amplitudes for each moment.
+   *
+   * The weights combine (2 pi f)^k with the trapezoid rule for the
+   * frequencies in _freqs, so that a moment is the dot product of the weights
+   * and the squared amplitudes.
+   */
+  QVector<double> _weights[weightedMomentCount];
+
+  //! Serializes updates of the frequencies and weights
+  QMutex _weightsMutex;
 };
 
 #endif // ABSTRACTPEAKCALCULATOR_H
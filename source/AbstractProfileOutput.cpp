@@ -31,6 +31,7 @@
 #include "SubLayer.h"
 #include "Units.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <QDebug>
@@ -119,6 +120,62 @@ void AbstractProfileOutput::extrap(const QVector<double> &ref,
   data << std::max(DBL_MIN, data.last() + slope * layerThickness / 2.);
 }
 
+auto AbstractProfileOutput::locations(const SoilProfile *site) const
+    -> QVector<Location> {
+  QVector<Location> locs;
+  locs.reserve(ref().size());
+
+  for (const double &depth : ref())
+    locs << site->depthToLocation(depth);
+
+  return locs;
+}
+
+auto AbstractProfileOutput::calcAccelTfs(
+    AbstractCalculator *const calculator) const
+    -> const QVector<QVector<std::complex<double>>> & {
+  QVector<QVector<std::complex<double>>> &tfs = calculator->tfScratch(0);
+  const SoilProfile *site = calculator->site();
+  const QVector<Location> outLocations = locations(site);
+
+  // Outcrop for the first layer. Within for subsequent.
+  QVector<AbstractMotion::Type> outputTypes(outLocations.size(),
+                                            AbstractMotion::Within);
+  if (!outputTypes.isEmpty())
+    outputTypes.first() = AbstractMotion::Outcrop;
+
+  calculator->calcAccelTfs(site->inputLocation(), calculator->motion()->type(),
+                           outLocations, outputTypes, tfs);
+  return tfs;
+}
+
+void AbstractProfileOutput::calcStrainStressTfs(
+    AbstractCalculator *const calculator,
+    const QVector<QVector<std::complex<double>>> **strainTfs,
+    const QVector<QVector<std::complex<double>>> **stressTfs) const {
+  const SoilProfile *site = calculator->site();
+  const QVector<Location> outLocations = locations(site);
+
+  QVector<QVector<std::complex<double>>> &strain = calculator->tfScratch(0);
+  calculator->calcStrainTfs(site->inputLocation(),
+                            calculator->motion()->type(), outLocations,
+                            strain);
+
+  // The stress transfer functions are the strain transfer functions scaled
+  // by the complex shear modulus. Copy into the existing rows to keep their
+  // storage.
+  QVector<QVector<std::complex<double>>> &stress = calculator->tfScratch(1);
+  stress.resize(strain.size());
+  for (int j = 0; j < strain.size(); ++j) {
+    stress[j].resize(strain.at(j).size());
+    std::copy(strain.at(j).cbegin(), strain.at(j).cend(), stress[j].begin());
+    calculator->strainToStressTf(outLocations.at(j), stress[j]);
+  }
+
+  *strainTfs = &strain;
+  *stressTfs = &stress;
+}
+
 void AbstractProfileOutput::fromJson(const QJsonObject &json) {
   AbstractOutput::fromJson(json);
   _enabled = json["enabled"].toBool();
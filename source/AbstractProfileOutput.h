@@ -23,12 +23,16 @@
 #define ABSTRACT_PROFILE_OUTPUT_H
 
 #include "AbstractOutput.h"
+#include "Location.h"
 
 #include <QDataStream>
 #include <QJsonObject>
 
+#include <complex>
+
 class OutputStatistics;
 class OutputCatalog;
+class SoilProfile;
 
 class AbstractProfileOutput : public AbstractOutput {
   Q_OBJECT
@@ -73,6 +77,27 @@ protected:
   void extrap(const QVector<double> &ref, QVector<double> &data,
               double layerThickness) const;
 
+  //! Locations in the site profile of the output depths
+  auto locations(const SoilProfile *site) const -> QVector<Location>;
+
+  /*! Compute the acceleration transfer functions at the output depths.
+   * Outcrop motion is used for the first depth and within motion for the
+   * others.
+   * \return transfer functions, which are stored by the calculator and are
+   * valid until the next transfer functions are computed
+   */
+  auto calcAccelTfs(AbstractCalculator *const calculator) const
+      -> const QVector<QVector<std::complex<double>>> &;
+
+  /*! Compute the strain and stress transfer functions at the output depths.
+   * Both are stored by the calculator and are valid until the next transfer
+   * functions are computed.
+   */
+  void calcStrainStressTfs(
+      AbstractCalculator *const calculator,
+      const QVector<QVector<std::complex<double>>> **strainTfs,
+      const QVector<QVector<std::complex<double>>> **stressTfs) const;
+
   //! If the output is enabled
   bool _enabled;
 };
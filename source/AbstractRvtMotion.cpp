@@ -33,6 +33,7 @@
 #include <QApplication>
 #include <QDebug>
 #include <QFile>
+#include <QThread>
 
 #include <qwt_scale_engine.h>
 #include <qwt_text.h>
@@ -52,6 +53,25 @@ auto AbstractRvtMotion::regionList() -> QStringList {
   return {tr("Western NA"), tr("Eastern NA")}; //, tr("Unknown")};
 }
 
+auto AbstractRvtMotion::peakFactorMethodList() -> QStringList {
+  return {tr("Integration"), tr("Tabulated")};
+}
+
+auto AbstractRvtMotion::peakFactorMethod() const
+    -> VanmarckePeakCalculator::PeakFactorMethod {
+  if (auto *vpc = dynamic_cast<VanmarckePeakCalculator *>(_peakCalculator)) {
+    return vpc->peakFactorMethod();
+  }
+  return VanmarckePeakCalculator::Integration;
+}
+
+void AbstractRvtMotion::setPeakFactorMethod(
+    VanmarckePeakCalculator::PeakFactorMethod method) {
+  if (auto *vpc = dynamic_cast<VanmarckePeakCalculator *>(_peakCalculator)) {
+    vpc->setPeakFactorMethod(method);
+  }
+}
+
 auto AbstractRvtMotion::rowCount(const QModelIndex &parent) const -> int {
   Q_UNUSED(parent);
 
@@ -154,24 +174,29 @@ auto AbstractRvtMotion::computeSa(const QVector<double> &period, double damping,
     -> QVector<double> {
   // Compute the response at each period
   updatePeakCalculatorScenario();
-  QVector<double> sa;
-  QVector<double> fourierAcc(_fourierAcc.size());
-  for (double oscPeriod : period) {
-    const QVector<std::complex<double>> sdofTf = calcSdofTf(oscPeriod, damping);
-    Q_ASSERT(sdofTf.size() == fourierAcc.size());
+  const QSharedPointer<const SdofTfBank> bank = sdofTfBank(period, damping);
 
+  // Apply the site transfer function once for all of the oscillators
+  QVector<double> fourierAcc = _fourierAcc;
+  if (accelTf.size()) {
     for (int i = 0; i < fourierAcc.size(); ++i) {
-      fourierAcc[i] = abs(sdofTf.at(i)) * _fourierAcc.at(i);
-      if (accelTf.size()) {
-        fourierAcc[i] *= abs(accelTf.at(i));
-      }
+      fourierAcc[i] *= abs(accelTf.at(i));
     }
+  }
 
-    sa << _peakCalculator->calcPeak(_duration, freq(), fourierAcc,
-                                    (1 / oscPeriod), damping, accelTf);
+  QVector<double> oscFreqs(period.size());
+  for (int i = 0; i < period.size(); ++i) {
+    oscFreqs[i] = 1 / period.at(i);
   }
 
-  return sa;
+  // During a run the motions are already computed in parallel, so the
+  // oscillators are only split across threads when called from the GUI.
+  const bool parallel =
+      QCoreApplication::instance() &&
+      QThread::currentThread() == QCoreApplication::instance()->thread();
+
+  return _peakCalculator->calcPeaks(_duration, freq(), fourierAcc, oscFreqs,
+                                    damping, *bank, accelTf, parallel);
 }
 
 auto AbstractRvtMotion::absFourierAcc(
@@ -264,6 +289,13 @@ auto AbstractRvtMotion::loadFromTextStream(QTextStream &stream, double scale)
 }
 
 void AbstractRvtMotion::calculate() {
+  calculatePeaks();
+
+  // The response spectrum is only computed when it is needed
+  invalidateRespSpec();
+}
+
+void AbstractRvtMotion::calculatePeaks() {
   if (auto btpc =
           dynamic_cast<BooreThompsonPeakCalculator *>(_peakCalculator)) {
     btpc->setScenario(_magnitude, _distance, _region);
@@ -272,9 +304,6 @@ void AbstractRvtMotion::calculate() {
   // Compute the PGA and PGV
   setPga(max());
   setPgv(maxVel());
-
-  // Compute the response spectra
-  _respSpec->setSa(computeSa(_respSpec->period(), _respSpec->damping()));
 }
 
 auto AbstractRvtMotion::calcMax(const QVector<double> &fourierAmps) const
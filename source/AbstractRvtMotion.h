@@ -25,6 +25,7 @@
 #include "AbstractMotion.h"
 
 #include "AbstractPeakCalculator.h"
+#include "VanmarckePeakCalculator.h"
 
 #include <QAbstractTableModel>
 #include <QDataStream>
@@ -55,6 +56,7 @@ public:
   };
 
   static auto regionList() -> QStringList;
+  static auto peakFactorMethodList() -> QStringList;
 
   auto region() const -> Region;
   auto magnitude() const -> double;
@@ -62,6 +64,10 @@ public:
 
   virtual void setRegion(AbstractRvtMotion::Region region);
 
+  //! Method used by the peak calculator to compute the peak factor
+  auto peakFactorMethod() const -> VanmarckePeakCalculator::PeakFactorMethod;
+  void setPeakFactorMethod(VanmarckePeakCalculator::PeakFactorMethod method);
+
   //!@{ Methods for viewing the Fourier amplitude spectrum of the motion
   virtual auto rowCount(const QModelIndex &parent) const -> int;
   virtual auto columnCount(const QModelIndex &parent) const -> int;
@@ -125,7 +131,8 @@ public slots:
   //! Stop the current calculation
   void stop();
 
-  //! Calculate the response spectrum of the motion
+  //! Calculate the properties of the motion, and mark the response spectrum
+  //! to be computed when it is needed
   virtual void calculate();
 
   void setRegion(int region);
@@ -146,6 +153,9 @@ signals:
   void distanceChanged(double distance);
 
 protected:
+  //! Calculate the PGA and PGV without changing the response spectrum
+  void calculatePeaks();
+
   //! Columns for the table
   enum Column { FrequencyColumn, AmplitudeColumn };
 
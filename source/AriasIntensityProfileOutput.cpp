@@ -59,16 +59,11 @@ void AriasIntensityProfileOutput::extract(AbstractCalculator *const calculator,
   Q_UNUSED(ref)
 
   const auto *tsm = static_cast<const TimeSeriesMotion *>(calculator->motion());
-  const SoilProfile *site = calculator->site();
 
-  // Outcrop for the first layer. Within for subsequent.
-  AbstractMotion::Type type = AbstractMotion::Outcrop;
+  const QVector<QVector<std::complex<double>>> &tfs =
+      calcAccelTfs(calculator);
 
-  for (const double &depth : this->ref()) {
-    data << tsm->ariasIntensity(
-                   calculator->calcAccelTf(site->inputLocation(), tsm->type(),
-                                           site->depthToLocation(depth), type))
-                .constLast();
-    type = AbstractMotion::Within;
-  }
+  data.reserve(tfs.size());
+  for (const QVector<std::complex<double>> &tf : std::as_const(tfs))
+    data << tsm->ariasIntensity(tf).constLast();
 }
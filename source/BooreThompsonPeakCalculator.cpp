@@ -28,69 +28,90 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
+#include <algorithm>
 #include <cmath>
 
+namespace {
+//! Model coefficients tabulated over magnitude and distance for one region
+struct CoeffTable {
+  static const int nmags = 13;
+  static const int ndists = 15;
+
+  double mag[nmags];
+  double lnDist[ndists];
+  //! Coefficients with magnitude varying fastest
+  double coeffs[BooreThompsonPeakCalculator::coeffCount][ndists * nmags];
+};
+
+auto loadCoeffTable(const QString &region) -> CoeffTable {
+  CoeffTable table = {};
+
+  // Load the JSON and convert to vectors
+  QString fileName = QString(":/data/%1_bt15_trms4osc.json").arg(region);
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qCritical("Unable to open file: %s", qPrintable(fileName));
+    return table;
+  }
+
+  QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+
+  QVector<double> values;
+  Serialize::toDoubleVector(json["M"], values);
+  for (int i = 0; i < CoeffTable::nmags; ++i) {
+    table.mag[i] = values.at(i);
+  }
+
+  // Pre-compute log distances
+  Serialize::toDoubleVector(json["R"], values);
+  for (int i = 0; i < CoeffTable::ndists; ++i) {
+    table.lnDist[i] = log(values.at(i * CoeffTable::nmags));
+  }
+
+  for (int k = 0; k < BooreThompsonPeakCalculator::coeffCount; ++k) {
+    Serialize::toDoubleVector(json[QString("c%1").arg(k + 1)], values);
+    std::copy_n(values.constData(),
+                std::min(int(values.size()),
+                         CoeffTable::ndists * CoeffTable::nmags),
+                table.coeffs[k]);
+  }
+
+  return table;
+}
+
+//! Tables for CENA and WNA, which are loaded once and shared by all
+//! calculators
+auto coeffTable(AbstractRvtMotion::Region region) -> const CoeffTable & {
+  static const CoeffTable cena = loadCoeffTable("cena");
+  static const CoeffTable wna = loadCoeffTable("wna");
+
+  return region == AbstractRvtMotion::CEUS ? cena : wna;
+}
+
+/*! Find the interval containing the value and the fractional position
+ *
+ * \param x sorted values
+ * \param n number of values
+ * \param value value clipped to the range of x
+ * \param frac fractional position within the interval
+ * \return index of the start of the interval
+ */
+auto findInterval(const double *x, int n, double value, double &frac) -> int {
+  const int i = std::max(
+      0, std::min(int(std::upper_bound(x, x + n, value) - x) - 1, n - 2));
+  frac = (value - x[i]) / (x[i + 1] - x[i]);
+  return i;
+}
+} // namespace
+
 BooreThompsonPeakCalculator::BooreThompsonPeakCalculator() {
   _mag = -1;
   _dist = -1;
   _region = AbstractRvtMotion::Unknown;
   _name = "Boore & Thompson (2015)";
-  _nmags = 13;
-  _ndists = 15;
-
-  const int total = _nmags * _ndists;
-
-  _interp = gsl_interp2d_alloc(gsl_interp2d_bilinear, _nmags, _ndists);
-  _magAcc = gsl_interp_accel_alloc();
-  _lnDistAcc = gsl_interp_accel_alloc();
-
-  // Load the model coefficients
-  for (const QString &region : {QString("cena"), QString("wna")}) {
-    // Load the JSON and convert to vectors
-    QString fileName =
-        QString(":/data/%1_bt15_trms4osc.json").arg(region).toUtf8();
-
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
-      qCritical("Unable to open file: %s", qPrintable(fileName));
-      continue;
-    }
-
-    QByteArray savedData = file.readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(savedData);
-    QJsonObject json = jsonDoc.object();
-
-    QMap<QString, QVector<double>> paramMap;
-    const QStringList keys = json.keys();
-    for (const QString &key : keys) {
-      Serialize::toDoubleVector(json[key], paramMap[key]);
-    }
-
-    auto data = QMap<QString, QVector<double>>();
-    auto mag = QVector<double>(_nmags);
-    for (int i = 0; i < _nmags; ++i) {
-      mag[i] = paramMap["M"].at(i);
-    }
-    data["mag"] = mag;
-
-    // Pre-compute log distances
-    auto lnDist = QVector<double>(_ndists);
-    for (int i = 0; i < _ndists; ++i) {
-      lnDist[i] = log(paramMap["R"].at(i * _nmags));
-    }
-    data["lnDist"] = lnDist;
-
-    for (const QString &key : {"c1", "c2", "c3", "c4", "c5", "c6", "c7"}) {
-      data[key] = paramMap[key];
-    }
-    _tabularData[region] = data;
-  }
-}
 
-BooreThompsonPeakCalculator::~BooreThompsonPeakCalculator() {
-  gsl_interp2d_free(_interp);
-  gsl_interp_accel_free(_magAcc);
-  gsl_interp_accel_free(_lnDistAcc);
+  std::fill_n(_interped, coeffCount, 0.);
 }
 
 auto BooreThompsonPeakCalculator::mag() const -> double { return _mag; }
@@ -101,17 +122,6 @@ auto BooreThompsonPeakCalculator::region() const -> AbstractRvtMotion::Region {
   return _region;
 }
 
-auto BooreThompsonPeakCalculator::interpCoeff(
-    double mag, double lnDist, QMap<QString, QVector<double>> &data,
-    const QString &key) -> double {
-
-  gsl_interp2d_init(_interp, data["mag"].data(), data["lnDist"].data(),
-                    data[key].data(), _nmags, _ndists);
-
-  return gsl_interp2d_eval(_interp, data["mag"].data(), data["lnDist"].data(),
-                           data[key].data(), mag, lnDist, _magAcc, _lnDistAcc);
-}
-
 void BooreThompsonPeakCalculator::setScenario(
     double mag, double dist, AbstractRvtMotion::Region region) {
   Q_ASSERT(region != AbstractRvtMotion::Unknown);
@@ -120,33 +130,47 @@ void BooreThompsonPeakCalculator::setScenario(
   _dist = dist;
   _region = region;
 
-  QString regionStr = region == AbstractRvtMotion::CEUS ? "cena" : "wna";
-  auto data = _tabularData[regionStr];
+  const CoeffTable &table = coeffTable(region);
 
   double lnDist = log(dist);
 
   // Clip to the provided values
-  mag = std::max(data["mag"].first(), std::min(mag, data["mag"].last()));
-  lnDist =
-      std::max(data["lnDist"].first(), std::min(lnDist, data["lnDist"].last()));
-
-  for (const QString &key : {"c1", "c2", "c3", "c4", "c5", "c6", "c7"}) {
-    _interped[key] = interpCoeff(mag, lnDist, data, key);
+  mag = std::max(table.mag[0], std::min(mag, table.mag[table.nmags - 1]));
+  lnDist = std::max(table.lnDist[0],
+                    std::min(lnDist, table.lnDist[table.ndists - 1]));
+
+  // Bilinear interpolation, the weights are shared by all coefficients
+  double t;
+  double u;
+  const int i = findInterval(table.mag, table.nmags, mag, t);
+  const int j = findInterval(table.lnDist, table.ndists, lnDist, u);
+
+  const int offset = j * table.nmags + i;
+  for (int k = 0; k < coeffCount; ++k) {
+    const double *c = table.coeffs[k] + offset;
+    _interped[k] = (1 - t) * (1 - u) * c[0] + t * (1 - u) * c[1] +
+                   (1 - t) * u * c[table.nmags] + t * u * c[table.nmags + 1];
   }
 }
 
 auto BooreThompsonPeakCalculator::calcDurationRms(
     double duration, double oscFreq, double oscDamping,
-    const QVector<std::complex<double>> &siteTransFunc) -> double {
+    const QVector<std::complex<double>> &siteTransFunc) const -> double {
   Q_UNUSED(siteTransFunc);
   if (oscFreq > 0 && oscDamping > 0) {
+    const double c1 = _interped[0];
+    const double c2 = _interped[1];
+    const double c3 = _interped[2];
+    const double c4 = _interped[3];
+    const double c5 = _interped[4];
+    const double c6 = _interped[5];
+    const double c7 = _interped[6];
+
     double foo = 1 / (oscFreq * duration);
     double durRatio =
-        ((_interped["c1"] + _interped["c2"] * (1 - pow(foo, _interped["c3"])) /
-                                (1 + pow(foo, _interped["c3"]))) *
-         (1 + _interped["c4"] / (2 * M_PI * oscDamping / 100) *
-                  pow(foo / (1 + _interped["c5"] * pow(foo, _interped["c6"])),
-                      _interped["c7"])));
+        ((c1 + c2 * (1 - pow(foo, c3)) / (1 + pow(foo, c3))) *
+         (1 + c4 / (2 * M_PI * oscDamping / 100) *
+                  pow(foo / (1 + c5 * pow(foo, c6)), c7)));
     duration *= durRatio;
   }
   return duration;
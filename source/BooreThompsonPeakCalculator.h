@@ -25,16 +25,14 @@
 #include "AbstractRvtMotion.h"
 #include "VanmarckePeakCalculator.h"
 
-#include <QMap>
-#include <QString>
 #include <QVector>
 
-#include <gsl/gsl_interp2d.h>
-
 class BooreThompsonPeakCalculator : public VanmarckePeakCalculator {
 public:
   explicit BooreThompsonPeakCalculator();
-  ~BooreThompsonPeakCalculator();
+
+  //! Number of model coefficients
+  static const int coeffCount = 7;
 
   void setScenario(double mag, double dist, AbstractRvtMotion::Region region);
 
@@ -45,25 +43,11 @@ public:
 protected:
   virtual auto
   calcDurationRms(double duration, double oscFreq, double oscDamping,
-                  const QVector<std::complex<double>> &siteTransFunc) -> double;
-
-  auto interpCoeff(double mag, double lnDist,
-                   QMap<QString, QVector<double>> &data, const QString &key)
+                  const QVector<std::complex<double>> &siteTransFunc) const
       -> double;
 
-  // Interpolation and dimensions
-  gsl_interp2d *_interp;
-  gsl_interp_accel *_magAcc;
-  gsl_interp_accel *_lnDistAcc;
-
-  qint32 _nmags;
-  qint32 _ndists;
-
-  // Model coefficients
-  QMap<QString, QMap<QString, QVector<double>>> _tabularData;
-
-  // Selected model coefficients
-  QMap<QString, double> _interped;
+  //! Model coefficients (c1 through c7) interpolated for the scenario
+  double _interped[coeffCount];
 
   // Scenario parameters
   double _mag;
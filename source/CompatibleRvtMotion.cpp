@@ -224,7 +224,7 @@ void CompatibleRvtMotion::calculate() {
   // Initial response spectrum
   _respSpec->setDamping(_targetRespSpec->damping());
   _respSpec->setPeriod(_targetRespSpec->period());
-  _respSpec->setSa(
+  setRespSpecSa(
       computeSa(_targetRespSpec->period(), _targetRespSpec->damping()));
 
   QVector<double> ratio(_respSpec->sa().size());
@@ -319,7 +319,7 @@ void CompatibleRvtMotion::calculate() {
     }
 
     // Re-compute the Sa
-    _respSpec->setSa(
+    setRespSpecSa(
         computeSa(_targetRespSpec->period(), _targetRespSpec->damping()));
 
     // Compute the root-mean-squared error
@@ -366,7 +366,8 @@ void CompatibleRvtMotion::calculate() {
   // Signal that the changes have taken place
   endResetModel();
 
-  AbstractRvtMotion::calculate();
+  // Keep the response spectrum of the fit
+  calculatePeaks();
 }
 
 auto CompatibleRvtMotion::vanmarckeInversion() const -> QVector<double> {
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ComplexMatrix.h"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+//! Alignment of the planes and rows in bytes
+const std::size_t alignment = 64;
+} // namespace
+
+ComplexMatrix::ComplexMatrix()
+    : _rows(0), _cols(0), _stride(0), _re(nullptr), _im(nullptr) {}
+
+ComplexMatrix::~ComplexMatrix() { free(); }
+
+void ComplexMatrix::resize(int rows, int cols) {
+  free();
+
+  _rows = rows;
+  _cols = cols;
+
+  // Pad the rows so that each starts on an aligned address
+  const std::ptrdiff_t perAlignment = alignment / sizeof(double);
+  _stride = ((cols + perAlignment - 1) / perAlignment) * perAlignment;
+
+  const std::size_t size = std::max<std::ptrdiff_t>(1, rows * _stride);
+  _re = static_cast<double *>(
+      ::operator new[](size * sizeof(double), std::align_val_t(alignment)));
+  _im = static_cast<double *>(
+      ::operator new[](size * sizeof(double), std::align_val_t(alignment)));
+
+  std::fill(_re, _re + size, 0.);
+  std::fill(_im, _im + size, 0.);
+}
+
+void ComplexMatrix::fill(int row, const std::complex<double> &value) {
+  std::fill(re(row), re(row) + _cols, value.real());
+  std::fill(im(row), im(row) + _cols, value.imag());
+}
+
+void ComplexMatrix::free() {
+  if (_re) {
+    ::operator delete[](_re, std::align_val_t(alignment));
+    ::operator delete[](_im, std::align_val_t(alignment));
+  }
+
+  _re = nullptr;
+  _im = nullptr;
+}
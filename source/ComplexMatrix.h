@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef COMPLEX_MATRIX_H_
+#define COMPLEX_MATRIX_H_
+
+#include <complex>
+#include <cstddef>
+
+/*! Matrix of complex values stored as separate real and imaginary planes.
+ *
+ * The values are stored row-major with each row padded to a multiple of 64
+ * bytes, and each plane is aligned to 64 bytes. The rows are used for the
+ * layers and the columns for the frequencies, so that a kernel looping over
+ * the frequencies of a layer reads contiguous memory. Such a kernel can be
+ * vectorized by the compiler if it has no branches and calls no math
+ * functions without vector versions.
+ */
+class ComplexMatrix {
+public:
+  ComplexMatrix();
+  ~ComplexMatrix();
+
+  ComplexMatrix(const ComplexMatrix &) = delete;
+  auto operator=(const ComplexMatrix &) -> ComplexMatrix & = delete;
+
+  //! Resize the matrix. The values are set to zero.
+  void resize(int rows, int cols);
+
+  auto rows() const -> int { return _rows; }
+  auto cols() const -> int { return _cols; }
+
+  inline auto at(int row, int col) const -> std::complex<double>;
+  inline void set(int row, int col, const std::complex<double> &value);
+
+  //! Set all values of a row
+  void fill(int row, const std::complex<double> &value);
+
+  //! Real part of a row
+  auto re(int row) -> double * { return _re + row * _stride; }
+  auto re(int row) const -> const double * { return _re + row * _stride; }
+
+  //! Imaginary part of a row
+  auto im(int row) -> double * { return _im + row * _stride; }
+  auto im(int row) const -> const double * { return _im + row * _stride; }
+
+private:
+  void free();
+
+  int _rows;
+  int _cols;
+
+  //! Distance between the start of two rows
+  std::ptrdiff_t _stride;
+
+  double *_re;
+  double *_im;
+};
+
+auto ComplexMatrix::at(int row, int col) const -> std::complex<double> {
+  const std::ptrdiff_t i = row * _stride + col;
+  return {_re[i], _im[i]};
+}
+
+void ComplexMatrix::set(int row, int col, const std::complex<double> &value) {
+  const std::ptrdiff_t i = row * _stride + col;
+  _re[i] = value.real();
+  _im[i] = value.imag();
+}
+
+#endif // COMPLEX_MATRIX_H_
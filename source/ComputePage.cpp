@@ -21,6 +21,7 @@
 
 #include "ComputePage.h"
 
+#include "MotionLibrary.h"
 #include "OutputCatalog.h"
 #include "SiteResponseModel.h"
 #include "TextLog.h"
@@ -91,8 +92,10 @@ void ComputePage::setModel(SiteResponseModel *model) {
   connect(_cancelButton, &QPushButton::clicked, model,
           &SiteResponseModel::stop);
 
-  connect(this, &ComputePage::startCalculation, model,
-          [model]() { model->start(); });
+  connect(this, &ComputePage::startCalculation, model, [model]() {
+    model->motionLibrary()->waitForPreprocess();
+    model->start();
+  });
   connect(model, &SiteResponseModel::finished, this, &ComputePage::reset);
 
   _logView->clear();
@@ -123,6 +126,8 @@ void ComputePage::compute() {
 
   _cancelButton->setCursor(Qt::BusyCursor);
 
+  // The motions are used by the calculation threads
+  _model->motionLibrary()->waitForPreprocess();
   _model->start();
 }
 
@@ -49,7 +49,6 @@ auto CustomNonlinearProperty::setData(const QModelIndex &index,
     case PropertyColumn:
       _average[index.row()] = d;
       _varied[index.row()] = d;
-      gsl_interp_accel_reset(_acc);
       break;
     }
     emit dataChanged(index, index);
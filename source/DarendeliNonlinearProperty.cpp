@@ -33,7 +33,6 @@ DarendeliNonlinearProperty::DarendeliNonlinearProperty(Type type,
   _type = type;
   _strain = Dimension::logSpace(pow(10., -4), pow(10., 1), 21);
   _average.resize(_strain.size());
-  initialize();
 }
 
 void DarendeliNonlinearProperty::calculate(const SoilType *soilType) {
@@ -62,25 +62,22 @@ void DissipatedEnergyProfileOutput::extract(
   Q_UNUSED(ref);
 
   auto *tsm = static_cast<const TimeSeriesMotion *>(calculator->motion());
+  const QVector<QVector<std::complex<double>>> *strainTfs;
+  const QVector<QVector<std::complex<double>>> *stressTfs;
+  calcStrainStressTfs(calculator, &strainTfs, &stressTfs);
 
-  for (const double &depth : this->ref()) {
-    if (abs(depth - 0) < 0.01) {
+  for (int j = 0; j < this->ref().size(); ++j) {
+    if (abs(this->ref().at(j) - 0) < 0.01) {
       // No values at the surface
       data << 0.;
     } else {
       // Compute the strain and visco-elastic stress time series without
       // baseline correction
-      const QVector<double> strainTs = tsm->strainTimeSeries(
-          calculator->calcStrainTf(calculator->site()->inputLocation(),
-                                   calculator->motion()->type(),
-                                   calculator->site()->depthToLocation(depth)),
-          false);
-
-      const QVector<double> stressTs = tsm->strainTimeSeries(
-          calculator->calcStressTf(calculator->site()->inputLocation(),
-                                   calculator->motion()->type(),
-                                   calculator->site()->depthToLocation(depth)),
-          false);
+      const QVector<double> strainTs =
+          tsm->strainTimeSeries(strainTfs->at(j), false);
+
+      const QVector<double> stressTs =
+          tsm->strainTimeSeries(stressTfs->at(j), false);
 
       // Integrate the loop using the trapezoid rule
       double sum = 0;
@@ -45,6 +45,14 @@ auto EquivalentLinearCalculator::toHtml() const -> QString {
       .arg(_maxIterations);
 }
 
+auto EquivalentLinearCalculator::duplicate() const -> AbstractCalculator * {
+  auto *calc = new EquivalentLinearCalculator;
+  copyIterativeSettings(calc);
+  calc->_strainRatio = _strainRatio;
+
+  return calc;
+}
+
 auto EquivalentLinearCalculator::strainRatio() const -> double {
   return _strainRatio;
 }
@@ -66,40 +74,49 @@ auto EquivalentLinearCalculator::updateSubLayer(
     return false;
   }
 
-  if (!_site->subLayers()[index].setStrain(_strainRatio * strainMax,
-                                           strainMax)) {
+  return applyStrain(index, _strainRatio * strainMax);
+}
+
+auto EquivalentLinearCalculator::canAccelerate() const -> bool { return true; }
+
+auto EquivalentLinearCalculator::applyStrain(int index, double effStrain)
+    -> bool {
+  if (!_site->subLayers()[index].setStrain(effStrain,
+                                           effStrain / _strainRatio)) {
     return false;
   }
 
   // Compute the complex shear modulus and complex shear-wave velocity
   // for each soil layer -- these change because the damping and shear
   // modulus change.
-  _shearMod[index].fill(
-      calcCompShearMod(_site->subLayers().at(index).shearMod(),
-                       _site->subLayers().at(index).damping() / 100.));
+  _shearMod.fill(
+      index, calcCompShearMod(_site->subLayers().at(index).shearMod(),
+                              _site->subLayers().at(index).damping() / 100.));
 
   return true;
 }
 
 void EquivalentLinearCalculator::estimateInitialStrains() {
-  if (_textLog->level() > TextLog::Low) {
-    _textLog->append(
-        tr("\t\tEstimating strains using PGV and shear velocity."));
-  }
-
-  // Estimate the intial strain from the ratio of peak ground velocity of the
-  //  motion and the shear-wave velocity of the layer.
-  double estimatedStrain = 0;
-  for (SubLayer &sl : _site->subLayers()) {
-    estimatedStrain = _motion->pgv() / sl.shearVel();
-    sl.setInitialStrain(estimatedStrain);
+  if (!applyWarmStart()) {
+    if (_textLog->level() > TextLog::Low) {
+      _textLog->append(
+          tr("\t\tEstimating strains using PGV and shear velocity."));
+    }
+
+    // Estimate the intial strain from the ratio of peak ground velocity of
+    // the motion and the shear-wave velocity of the layer.
+    double estimatedStrain = 0;
+    for (SubLayer &sl : _site->subLayers()) {
+      estimatedStrain = _motion->pgv() / sl.shearVel();
+      sl.setInitialStrain(estimatedStrain);
+    }
   }
 
   // Compute the complex shear modulus and complex shear-wave velocity for
   // each soil layer -- initially this is assumed to be frequency independent
   for (int i = 0; i < _nsl; ++i) {
-    _shearMod[i].fill(
-        calcCompShearMod(_site->shearMod(i), _site->damping(i) / 100.));
+    _shearMod.fill(i, calcCompShearMod(_site->shearMod(i),
+                                       _site->damping(i) / 100.));
   }
 }
 
@@ -40,6 +40,8 @@ public:
   EquivalentLinearCalculator(QObject *parent = nullptr);
 
   virtual auto toHtml() const -> QString;
+  virtual auto duplicate() const -> AbstractCalculator *;
+
   auto strainRatio() const -> double;
 
   void fromJson(const QJsonObject &json);
@@ -58,6 +60,9 @@ protected:
 
   virtual void estimateInitialStrains();
 
+  virtual auto canAccelerate() const -> bool;
+  virtual auto applyStrain(int index, double effStrain) -> bool;
+
   //! Ratio between the maximum strain and the strain of the layer
   double _strainRatio;
 };
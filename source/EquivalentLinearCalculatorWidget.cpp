@@ -46,6 +46,21 @@ EquivalentLinearCalculatorWidget::EquivalentLinearCalculatorWidget(
 
   layout->addRow(tr("Maximum number of iterations:"), _maxIterationsSpinBox);
 
+  // Iteration method
+  _iterationMethodComboBox = new QComboBox;
+  _iterationMethodComboBox->addItems(
+      AbstractIterativeCalculator::iterationMethodList());
+
+  layout->addRow(tr("Iteration method:"), _iterationMethodComboBox);
+
+  // Relaxation of the strain update
+  _relaxationSpinBox = new QDoubleSpinBox;
+  _relaxationSpinBox->setRange(0.1, 1.0);
+  _relaxationSpinBox->setSingleStep(0.1);
+  _relaxationSpinBox->setDecimals(2);
+
+  layout->addRow(tr("Relaxation:"), _relaxationSpinBox);
+
   // Effective Strain Ratio
   _strainRatioSpinBox = new QDoubleSpinBox;
   _strainRatioSpinBox->setRange(0.45, 0.80);
@@ -54,6 +69,16 @@ EquivalentLinearCalculatorWidget::EquivalentLinearCalculatorWidget(
 
   layout->addRow("Effective strain ratio:", _strainRatioSpinBox);
 
+  // Warm start
+  _useWarmStartCheckBox =
+      new QCheckBox(tr("Start from the strains of the previous realization"));
+  layout->addRow(_useWarmStartCheckBox);
+
+  // Incremental update
+  _incrementalCheckBox =
+      new QCheckBox(tr("Skip settled sublayers until the others converge"));
+  layout->addRow(_incrementalCheckBox);
+
   setLayout(layout);
 }
 
@@ -71,10 +96,31 @@ void EquivalentLinearCalculatorWidget::setCalculator(
   _maxIterationsSpinBox->setValue(elc->maxIterations());
   connect(_maxIterationsSpinBox, qOverload<int>(&QSpinBox::valueChanged), elc,
           &EquivalentLinearCalculator::setMaxIterations);
+
+  _iterationMethodComboBox->setCurrentIndex(elc->iterationMethod());
+  connect(_iterationMethodComboBox,
+          qOverload<int>(&QComboBox::currentIndexChanged), elc,
+          &EquivalentLinearCalculator::setIterationMethod);
+
+  _relaxationSpinBox->setValue(elc->relaxation());
+  connect(_relaxationSpinBox, qOverload<double>(&QDoubleSpinBox::valueChanged),
+          elc, &EquivalentLinearCalculator::setRelaxation);
+
+  _useWarmStartCheckBox->setChecked(elc->useWarmStart());
+  connect(_useWarmStartCheckBox, &QCheckBox::toggled, elc,
+          &EquivalentLinearCalculator::setUseWarmStart);
+
+  _incrementalCheckBox->setChecked(elc->incremental());
+  connect(_incrementalCheckBox, &QCheckBox::toggled, elc,
+          &EquivalentLinearCalculator::setIncremental);
 }
 
 void EquivalentLinearCalculatorWidget::setReadOnly(bool readOnly) {
   _strainRatioSpinBox->setReadOnly(readOnly);
   _errorToleranceSpinBox->setReadOnly(readOnly);
   _maxIterationsSpinBox->setReadOnly(readOnly);
+  _iterationMethodComboBox->setDisabled(readOnly);
+  _relaxationSpinBox->setReadOnly(readOnly);
+  _useWarmStartCheckBox->setDisabled(readOnly);
+  _incrementalCheckBox->setDisabled(readOnly);
 }
@@ -24,6 +24,8 @@
 
 #include <QWidget>
 
+#include <QCheckBox>
+#include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QSpinBox>
 
@@ -42,6 +44,10 @@ protected:
   QDoubleSpinBox *_strainRatioSpinBox;
   QDoubleSpinBox *_errorToleranceSpinBox;
   QSpinBox *_maxIterationsSpinBox;
+  QComboBox *_iterationMethodComboBox;
+  QDoubleSpinBox *_relaxationSpinBox;
+  QCheckBox *_useWarmStartCheckBox;
+  QCheckBox *_incrementalCheckBox;
 };
 
 #endif // EQUIVALENT_LINEAR_CALCULATOR_WIDGET_H
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "FourierTransform.h"
+
+#ifdef USE_FFTW
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+
+#include <fftw3.h>
+#else
+#include <gsl/gsl_fft_halfcomplex.h>
+#include <gsl/gsl_fft_real.h>
+
+#include <new>
+#endif
+
+namespace {
+//! Aligned buffer that is released when the thread exits
+class Workspace {
+public:
+  ~Workspace() { release(_data); }
+
+  auto data(int n) -> double * {
+    if (_size < n) {
+      release(_data);
+      _data = allocate(n);
+      _size = n;
+    }
+    return _data;
+  }
+
+  static auto allocate(int n) -> double * {
+#ifdef USE_FFTW
+    // Aligned for the SIMD codelets of FFTW
+    return static_cast<double *>(fftw_malloc(sizeof(double) * n));
+#else
+    return static_cast<double *>(::operator new[](
+        sizeof(double) * n, std::align_val_t(alignment)));
+#endif
+  }
+
+  static void release(double *data) {
+    if (!data)
+      return;
+#ifdef USE_FFTW
+    fftw_free(data);
+#else
+    ::operator delete[](data, std::align_val_t(alignment));
+#endif
+  }
+
+private:
+#ifndef USE_FFTW
+  static const std::size_t alignment = 64;
+#endif
+
+  double *_data = nullptr;
+  int _size = 0;
+};
+
+thread_local Workspace threadWorkspace;
+
+#ifdef USE_FFTW
+//! The FFTW planner is not thread-safe
+QMutex fftwPlannerMutex;
+
+/*! Cached in-place plan for a transform of size n.
+ *
+ * Plans are created once per size and kind, and never destroyed. They are
+ * planned on a buffer from fftw_malloc(), so that they may use the SIMD
+ * codelets, and are only applied to the workspaces, which have the same
+ * alignment. fftw_execute_r2r() is safe to call from multiple threads. Each
+ * thread keeps the plans it has used, so the planner mutex is only locked the
+ * first time a thread uses a size.
+ */
+auto fftwPlan(int n, fftw_r2r_kind kind) -> fftw_plan {
+  thread_local QHash<QPair<int, int>, fftw_plan> threadPlans;
+
+  const QPair<int, int> key(n, static_cast<int>(kind));
+  auto it = threadPlans.constFind(key);
+  if (it != threadPlans.constEnd())
+    return it.value();
+
+  static QHash<QPair<int, int>, fftw_plan> plans;
+
+  QMutexLocker locker(&fftwPlannerMutex);
+  fftw_plan p = plans.value(key, nullptr);
+  if (!p) {
+    double *scratch = Workspace::allocate(n);
+    p = fftw_plan_r2r_1d(n, scratch, scratch, kind, FFTW_ESTIMATE);
+    Workspace::release(scratch);
+    plans.insert(key, p);
+  }
+  threadPlans.insert(key, p);
+  return p;
+}
+#endif
+} // namespace
+
+namespace FourierTransform {
+auto workspace(int n) -> double * { return threadWorkspace.data(n); }
+
+void forward(int n) {
+  double *d = workspace(n);
+#ifdef USE_FFTW
+  fftw_execute_r2r(fftwPlan(n, FFTW_R2HC), d, d);
+#else
+  gsl_fft_real_radix2_transform(d, 1, n);
+#endif
+}
+
+void inverse(int n) {
+  double *d = workspace(n);
+#ifdef USE_FFTW
+  fftw_execute_r2r(fftwPlan(n, FFTW_HC2R), d, d);
+  for (int i = 0; i < n; ++i) {
+    // Scale by n
+    d[i] /= n;
+  }
+#else
+  gsl_fft_halfcomplex_radix2_inverse(d, 1, n);
+#endif
+}
+} // namespace FourierTransform
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FOURIER_TRANSFORM_H_
+#define FOURIER_TRANSFORM_H_
+
+/*! Real Fourier transforms on a per-thread workspace.
+ *
+ * The transforms are computed in place on an aligned buffer that is owned by
+ * the calling thread and reused by subsequent transforms. The values are
+ * stored in the halfcomplex format: the real parts of the frequencies
+ * 0 to n/2 followed by the imaginary parts of the frequencies n/2 - 1 to 1.
+ * The transforms use FFTW if USE_FFTW is defined, and GSL otherwise. With
+ * FFTW a plan is created once for each size and shared by all threads.
+ */
+namespace FourierTransform {
+/*! Workspace of the calling thread
+ *
+ * \param n number of values required
+ * \return buffer of at least n values. The contents are undefined if the
+ * buffer is grown.
+ */
+auto workspace(int n) -> double *;
+
+//! Real to halfcomplex transform of the first n values of the workspace
+void forward(int n);
+
+//! Halfcomplex to real transform of the first n values of the workspace,
+//! scaled by 1/n
+void inverse(int n);
+} // namespace FourierTransform
+
+#endif // FOURIER_TRANSFORM_H_
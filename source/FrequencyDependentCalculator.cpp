@@ -32,12 +32,29 @@
 #include <QDebug>
 
 FrequencyDependentCalculator::FrequencyDependentCalculator(QObject *parent)
-    : AbstractIterativeCalculator(parent) {
+    : AbstractIterativeCalculator(parent), _fitSize(0), _fitWork(nullptr),
+      _fitModel(nullptr), _fitData(nullptr), _fitParams(nullptr),
+      _fitCov(nullptr) {
   _name = "EQL-FDM";
   _useSmoothSpectrum = false;
   reset();
 }
 
+FrequencyDependentCalculator::~FrequencyDependentCalculator() {
+  freeFitWorkspace();
+}
+
+void FrequencyDependentCalculator::freeFitWorkspace() {
+  if (_fitSize > 0) {
+    gsl_multifit_linear_free(_fitWork);
+    gsl_matrix_free(_fitModel);
+    gsl_vector_free(_fitData);
+    gsl_vector_free(_fitParams);
+    gsl_matrix_free(_fitCov);
+    _fitSize = 0;
+  }
+}
+
 auto FrequencyDependentCalculator::useSmoothSpectrum() -> bool {
   return _useSmoothSpectrum;
 }
@@ -61,6 +78,14 @@ auto FrequencyDependentCalculator::toHtml() const -> QString {
       .arg(_maxIterations);
 }
 
+auto FrequencyDependentCalculator::duplicate() const -> AbstractCalculator * {
+  auto *calc = new FrequencyDependentCalculator;
+  copyIterativeSettings(calc);
+  calc->_useSmoothSpectrum = _useSmoothSpectrum;
+
+  return calc;
+}
+
 auto FrequencyDependentCalculator::updateSubLayer(
     int index, const QVector<std::complex<double>> &strainTf) -> bool {
   const double strainMax = 100 * _motion->calcMaxStrain(strainTf);
@@ -76,9 +101,9 @@ auto FrequencyDependentCalculator::updateSubLayer(
   // doesn't appear to be representative
   _site->subLayers()[index].setStrain(strainMax, strainMax);
 
-  double shearMod;
-  double damping;
-  double strain;
+  // Strain at each frequency
+  _strains.resize(_nf);
+  double *strains = _strains.data();
   const SubLayer &sl = _site->subLayers().at(index);
 
   if (_useSmoothSpectrum) {
@@ -115,84 +140,91 @@ auto FrequencyDependentCalculator::updateSubLayer(
     // Calculate model parameter using a least squares fit
     const int n = _nf - offset;
     double chisq;
-    gsl_multifit_linear_workspace *work = gsl_multifit_linear_alloc(n, 2);
-    gsl_matrix *model = gsl_matrix_alloc(n, 2);
-    gsl_vector *data = gsl_vector_alloc(n);
-    gsl_vector *params = gsl_vector_alloc(2);
-    gsl_matrix *cov = gsl_matrix_alloc(2, 2);
+    if (_fitSize < n) {
+      // The workspace supports any number of observations up to its size
+      freeFitWorkspace();
+      _fitSize = _nf;
+      _fitWork = gsl_multifit_linear_alloc(_fitSize, 2);
+      _fitModel = gsl_matrix_alloc(_fitSize, 2);
+      _fitData = gsl_vector_alloc(_fitSize);
+      _fitParams = gsl_vector_alloc(2);
+      _fitCov = gsl_matrix_alloc(2, 2);
+    }
+    gsl_matrix_view model = gsl_matrix_submatrix(_fitModel, 0, 0, n, 2);
+    gsl_vector_view data = gsl_vector_subvector(_fitData, 0, n);
 
     for (int i = 0; i < n; ++i) {
-      gsl_matrix_set(model, i, 0, -freq.at(i + offset) / freqAvg);
-      gsl_matrix_set(model, i, 1, -log(freq.at(i + offset) / freqAvg));
-      gsl_vector_set(data, i, log(strainFas.at(i + offset) / strainAvg));
+      gsl_matrix_set(&model.matrix, i, 0, -freq.at(i + offset) / freqAvg);
+      gsl_matrix_set(&model.matrix, i, 1, -log(freq.at(i + offset) / freqAvg));
+      gsl_vector_set(&data.vector, i,
+                     log(strainFas.at(i + offset) / strainAvg));
     }
 
-    gsl_multifit_linear(model, data, params, cov, &chisq, work);
+    gsl_multifit_linear(&model.matrix, &data.vector, _fitParams, _fitCov,
+                        &chisq, _fitWork);
 
-    const double alpha = gsl_vector_get(params, 0);
-    const double beta = gsl_vector_get(params, 1);
+    const double alpha = gsl_vector_get(_fitParams, 0);
+    const double beta = gsl_vector_get(_fitParams, 1);
 
-    // Clean up
-    gsl_multifit_linear_free(work);
-    gsl_matrix_free(model);
-    gsl_vector_free(data);
-    gsl_vector_free(params);
-    gsl_matrix_free(cov);
-
-    // Compute the complex shear modulus and complex shear-wave velocity
-    // for each soil layer -- these change because the damping and shear
-    // modulus change.
     for (int i = 0; i < _nf; ++i) {
       // Compute the strain from the function
       // Use a slightly different formulation from Assimaki and Kausel to
       // provide a smooth taper
-      strain = std::min(1.0, exp(-alpha * freq.at(i) / freqAvg) /
-                                 pow(freq.at(i) / freqAvg, beta));
+      const double strain = std::min(1.0, exp(-alpha * freq.at(i) / freqAvg) /
+                                              pow(freq.at(i) / freqAvg, beta));
       // Scale strain by maximum strain
-      strain *= strainMax;
-
-      sl.interp(strain, &shearMod, &damping);
-      _shearMod[index][i] = calcCompShearMod(shearMod, damping / 100.);
+      strains[i] = strainMax * strain;
     }
-
-    return true;
   } else {
     double maxFas = 0;
     for (const double &d : strainFas) {
       maxFas = std::max(d, maxFas);
     }
     for (int i = 0; i < _nf; ++i) {
-      strain = strainMax * strainFas.at(i) / maxFas;
-      sl.interp(strain, &shearMod, &damping);
-      _shearMod[index][i] = calcCompShearMod(shearMod, damping / 100.);
+      strains[i] = strainMax * strainFas.at(i) / maxFas;
     }
   }
 
+  // Compute the complex shear modulus and complex shear-wave velocity
+  // for each soil layer -- these change because the damping and shear
+  // modulus change.
+  sl.interp(_strains, _shearMods, _dampings);
+  setCompShearMod(index, _shearMods, _dampings);
+
   return true;
 }
 
 void FrequencyDependentCalculator::estimateInitialStrains() {
-  if (_textLog->level() > TextLog::Low) {
-    _textLog->append(tr("\t\tEstimating strains using EQL method"));
-  }
+  // The EQL estimate is only needed without a warm start
+  if (!applyWarmStart()) {
+    if (_textLog->level() > TextLog::Low) {
+      _textLog->append(tr("\t\tEstimating strains using EQL method"));
+    }
 
-  auto *calc = new EquivalentLinearCalculator();
-  calc->setMaxIterations(_maxIterations);
-  calc->setTextLog(_textLog);
-  calc->run(_motion, _site);
+    auto *calc = new EquivalentLinearCalculator();
+    calc->setMaxIterations(_maxIterations);
+    // The frequency dependent properties are not described by a single
+    // strain, so only the initial EQL estimate is accelerated.
+    calc->setIterationMethod(_iterationMethod);
+    calc->setRelaxation(_relaxation);
+    calc->setIncremental(_incremental);
+    calc->setTextLog(_textLog);
+    calc->run(_motion, _site);
+    _iterationCount += calc->iterationCount();
+
+    for (SubLayer &sl : _site->subLayers()) {
+      sl.setInitialStrain(sl.effStrain());
+    }
 
-  for (SubLayer &sl : _site->subLayers()) {
-    sl.setInitialStrain(sl.effStrain());
+    delete calc;
   }
 
   // Compute the complex shear modulus and complex shear-wave velocity for
   // each soil layer -- initially this is assumed to be frequency independent
   for (int i = 0; i < _nsl; ++i) {
-    _shearMod[i].fill(
-        calcCompShearMod(_site->shearMod(i), _site->damping(i) / 100.));
+    _shearMod.fill(i, calcCompShearMod(_site->shearMod(i),
+                                       _site->damping(i) / 100.));
   }
-
-  delete calc;
 }
 
 void FrequencyDependentCalculator::fromJson(const QJsonObject &json) {
@@ -38,8 +38,10 @@ class FrequencyDependentCalculator : public AbstractIterativeCalculator {
 
 public:
   explicit FrequencyDependentCalculator(QObject *parent = nullptr);
+  ~FrequencyDependentCalculator();
 
   virtual auto toHtml() const -> QString;
+  virtual auto duplicate() const -> AbstractCalculator *;
 
   void fromJson(const QJsonObject &json);
   auto toJson() const -> QJsonObject;
@@ -58,7 +60,24 @@ protected:
       -> bool;
   virtual void estimateInitialStrains();
 
+  //! Free the workspace of the least-squares fit
+  void freeFitWorkspace();
+
   bool _useSmoothSpectrum;
+
+  //! Workspace of the least-squares fit of the smooth spectrum. These are
+  //! sized for the number of frequencies and reused between calls.
+  int _fitSize;
+  gsl_multifit_linear_workspace *_fitWork;
+  gsl_matrix *_fitModel;
+  gsl_vector *_fitData;
+  gsl_vector *_fitParams;
+  gsl_matrix *_fitCov;
+
+  //! Strain and properties at each frequency, reused between calls
+  QVector<double> _strains;
+  QVector<double> _shearMods;
+  QVector<double> _dampings;
 };
 
 #endif // FREQUENCY_DEPENDENT_CALCULATOR_H
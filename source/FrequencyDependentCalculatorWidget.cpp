@@ -46,11 +46,42 @@ FrequencyDependentCalculatorWidget::FrequencyDependentCalculatorWidget(
 
   layout->addRow(tr("Maximum number of iterations:"), _maxIterationsSpinBox);
 
+  // The frequency dependent properties are not described by a single strain,
+  // so the iteration method and relaxation only apply to the initial EQL
+  // estimate.
+  _iterationMethodComboBox = new QComboBox;
+  _iterationMethodComboBox->addItems(
+      AbstractIterativeCalculator::iterationMethodList());
+  _iterationMethodComboBox->setToolTip(
+      tr("Iteration method of the initial equivalent linear estimate"));
+
+  layout->addRow(tr("EQL estimate iteration method:"),
+                 _iterationMethodComboBox);
+
+  _relaxationSpinBox = new QDoubleSpinBox;
+  _relaxationSpinBox->setRange(0.1, 1.0);
+  _relaxationSpinBox->setSingleStep(0.1);
+  _relaxationSpinBox->setDecimals(2);
+  _relaxationSpinBox->setToolTip(
+      tr("Relaxation of the initial equivalent linear estimate"));
+
+  layout->addRow(tr("EQL estimate relaxation:"), _relaxationSpinBox);
+
   // Use smooth Strain FAS shape
   _useSmoothStrainCheckBox =
       new QCheckBox(tr("Use Kausel & Assimaki spectral shape"));
   layout->addRow(_useSmoothStrainCheckBox);
 
+  // Warm start
+  _useWarmStartCheckBox =
+      new QCheckBox(tr("Start from the strains of the previous realization"));
+  layout->addRow(_useWarmStartCheckBox);
+
+  // Incremental update
+  _incrementalCheckBox =
+      new QCheckBox(tr("Skip settled sublayers until the others converge"));
+  layout->addRow(_incrementalCheckBox);
+
   setLayout(layout);
 }
 
@@ -65,6 +96,23 @@ void FrequencyDependentCalculatorWidget::setCalculator(
   connect(_maxIterationsSpinBox, qOverload<int>(&QSpinBox::valueChanged), fdc,
           &FrequencyDependentCalculator::setMaxIterations);
 
+  _iterationMethodComboBox->setCurrentIndex(fdc->iterationMethod());
+  connect(_iterationMethodComboBox,
+          qOverload<int>(&QComboBox::currentIndexChanged), fdc,
+          &FrequencyDependentCalculator::setIterationMethod);
+
+  _relaxationSpinBox->setValue(fdc->relaxation());
+  connect(_relaxationSpinBox, qOverload<double>(&QDoubleSpinBox::valueChanged),
+          fdc, &FrequencyDependentCalculator::setRelaxation);
+
+  _useWarmStartCheckBox->setChecked(fdc->useWarmStart());
+  connect(_useWarmStartCheckBox, &QCheckBox::toggled, fdc,
+          &FrequencyDependentCalculator::setUseWarmStart);
+
+  _incrementalCheckBox->setChecked(fdc->incremental());
+  connect(_incrementalCheckBox, &QCheckBox::toggled, fdc,
+          &FrequencyDependentCalculator::setIncremental);
+
   _useSmoothStrainCheckBox->setChecked(fdc->useSmoothSpectrum());
   connect(_useSmoothStrainCheckBox, &QCheckBox::toggled, fdc,
           &FrequencyDependentCalculator::setUseSmoothSpectrum);
@@ -73,5 +121,9 @@ void FrequencyDependentCalculatorWidget::setCalculator(
 void FrequencyDependentCalculatorWidget::setReadOnly(bool readOnly) {
   _errorToleranceSpinBox->setReadOnly(readOnly);
   _maxIterationsSpinBox->setReadOnly(readOnly);
+  _iterationMethodComboBox->setDisabled(readOnly);
+  _relaxationSpinBox->setReadOnly(readOnly);
+  _useWarmStartCheckBox->setDisabled(readOnly);
+  _incrementalCheckBox->setDisabled(readOnly);
   _useSmoothStrainCheckBox->setDisabled(readOnly);
 }
@@ -25,6 +25,7 @@
 #include <QWidget>
 
 #include <QCheckBox>
+#include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QSpinBox>
 
@@ -43,6 +44,10 @@ public slots:
 protected:
   QDoubleSpinBox *_errorToleranceSpinBox;
   QSpinBox *_maxIterationsSpinBox;
+  QComboBox *_iterationMethodComboBox;
+  QDoubleSpinBox *_relaxationSpinBox;
+  QCheckBox *_useWarmStartCheckBox;
+  QCheckBox *_incrementalCheckBox;
   QCheckBox *_useSmoothStrainCheckBox;
 };
 
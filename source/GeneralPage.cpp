@@ -22,6 +22,7 @@
 #include "GeneralPage.h"
 
 #include "AbstractCalculator.h"
+#include "AbstractRvtMotion.h"
 #include "MethodGroupBox.h"
 #include "MotionLibrary.h"
 #include "MyRandomNumGenerator.h"
@@ -30,6 +31,7 @@
 #include "ProfileRandomizer.h"
 #include "SiteResponseModel.h"
 #include "SoilProfile.h"
+#include "TimeSeriesMotion.h"
 #include "Units.h"
 
 #include <QFormLayout>
@@ -113,10 +115,36 @@ auto GeneralPage::createAnalysisGroupBox() -> QGroupBox * {
   _approachComboBox->addItems(MotionLibrary::approachList());
   layout->addRow(tr("Approach:"), _approachComboBox);
 
+  // Response spectrum method
+  _responseSpectrumComboBox = new QComboBox;
+  _responseSpectrumComboBox->addItems(
+      TimeSeriesMotion::responseSpectrumMethodList());
+  _responseSpectrumComboBox->setToolTip(
+      tr("Method used to compute response spectra of time series. The time "
+         "domain method is faster for long records and short periods."));
+  layout->addRow(tr("Response spectrum:"), _responseSpectrumComboBox);
+
+  // RVT peak factor method
+  _peakFactorComboBox = new QComboBox;
+  _peakFactorComboBox->addItems(AbstractRvtMotion::peakFactorMethodList());
+  _peakFactorComboBox->setToolTip(
+      tr("Method used to compute RVT peak factors. The tabulated method "
+         "interpolates a precomputed table of the integral."));
+  layout->addRow(tr("Peak factor:"), _peakFactorComboBox);
+
   // Site varied
   _propertiesAreVariedCheckBox = new QCheckBox(tr("Vary the properties"));
   layout->addRow(_propertiesAreVariedCheckBox);
 
+  // Number of threads
+  _threadCountSpinBox = new QSpinBox;
+  _threadCountSpinBox->setRange(0, 256);
+  _threadCountSpinBox->setSpecialValueText(tr("Automatic"));
+  _threadCountSpinBox->setToolTip(
+      tr("Number of motions computed at the same time. Automatic uses the "
+         "number of processor cores."));
+  layout->addRow(tr("Worker threads:"), _threadCountSpinBox);
+
   // Create the group box and add the layout
   auto *groupBox = new QGroupBox(tr("Type of Analysis"));
   groupBox->setLayout(layout);
@@ -167,6 +195,14 @@ auto GeneralPage::createVariationGroupBox() -> QGroupBox * {
 
   layout->addRow(_specifiedSeedCheckBox, _seedSpinBox);
 
+  // Random number generation
+  _rngMethodComboBox = new QComboBox;
+  _rngMethodComboBox->addItems(MyRandomNumGenerator::methodList());
+  _rngMethodComboBox->setToolTip(
+      tr("Counter-based random numbers allow each realization to be "
+         "regenerated independently of the other realizations."));
+  layout->addRow(tr("Random numbers:"), _rngMethodComboBox);
+
   // Create the group box and add the layout
   _variationGroupBox = new QGroupBox(tr("Site Property Variation"));
   _variationGroupBox->setLayout(layout);
@@ -233,10 +269,27 @@ void GeneralPage::setModel(SiteResponseModel *model) {
   connect(_approachComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
           model->motionLibrary(), qOverload<int>(&MotionLibrary::setApproach));
 
+  _responseSpectrumComboBox->setCurrentIndex(
+      model->motionLibrary()->responseSpectrumMethod());
+  connect(_responseSpectrumComboBox,
+          qOverload<int>(&QComboBox::currentIndexChanged),
+          model->motionLibrary(),
+          qOverload<int>(&MotionLibrary::setResponseSpectrumMethod));
+
+  _peakFactorComboBox->setCurrentIndex(
+      model->motionLibrary()->peakFactorMethod());
+  connect(_peakFactorComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+          model->motionLibrary(),
+          qOverload<int>(&MotionLibrary::setPeakFactorMethod));
+
   _propertiesAreVariedCheckBox->setChecked(model->siteProfile()->isVaried());
   connect(_propertiesAreVariedCheckBox, &QCheckBox::toggled,
           model->siteProfile(), &SoilProfile::setIsVaried);
 
+  _threadCountSpinBox->setValue(model->threadCount());
+  connect(_threadCountSpinBox, qOverload<int>(&QSpinBox::valueChanged), model,
+          &SiteResponseModel::setThreadCount);
+
   _variationGroupBox->setEnabled(model->siteProfile()->isVaried());
   connect(model->siteProfile(), &SoilProfile::isVariedChanged,
           _variationGroupBox, &QGroupBox::setEnabled);
@@ -271,6 +324,13 @@ void GeneralPage::setModel(SiteResponseModel *model) {
   connect(model->randNumGen(), &MyRandomNumGenerator::seedChanged, _seedSpinBox,
           &QSpinBox::setValue);
 
+  _rngMethodComboBox->setCurrentIndex(model->randNumGen()->method());
+  connect(_rngMethodComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+          model->randNumGen(),
+          qOverload<int>(&MyRandomNumGenerator::setMethod));
+  connect(model->randNumGen(), &MyRandomNumGenerator::methodChanged,
+          _rngMethodComboBox, &QComboBox::setCurrentIndex);
+
   _methodGroupBox->setCalculator(model->calculator());
   connect(model, &SiteResponseModel::calculatorChanged, _methodGroupBox,
           &MethodGroupBox::setCalculator);
@@ -299,7 +359,10 @@ void GeneralPage::setReadOnly(bool readOnly) {
 
   _methodComboBox->setDisabled(readOnly);
   _approachComboBox->setDisabled(readOnly);
+  _responseSpectrumComboBox->setDisabled(readOnly);
+  _peakFactorComboBox->setDisabled(readOnly);
   _propertiesAreVariedCheckBox->setDisabled(readOnly);
+  _threadCountSpinBox->setReadOnly(readOnly);
 
   _countSpinBox->setReadOnly(readOnly);
   _onlyConvergedCheckBox->setDisabled(readOnly);
@@ -307,6 +370,7 @@ void GeneralPage::setReadOnly(bool readOnly) {
   _siteIsVariedCheckBox->setDisabled(readOnly);
   _specifiedSeedCheckBox->setDisabled(readOnly);
   _seedSpinBox->setDisabled(readOnly || !_specifiedSeedCheckBox->isChecked());
+  _rngMethodComboBox->setDisabled(readOnly);
 
   _methodGroupBox->setReadOnly(readOnly);
 
@@ -63,7 +63,10 @@ protected:
 
   QComboBox *_methodComboBox;
   QComboBox *_approachComboBox;
+  QComboBox *_responseSpectrumComboBox;
+  QComboBox *_peakFactorComboBox;
   QCheckBox *_propertiesAreVariedCheckBox;
+  QSpinBox *_threadCountSpinBox;
 
   QGroupBox *_variationGroupBox;
   QSpinBox *_countSpinBox;
@@ -72,6 +75,7 @@ protected:
   QCheckBox *_siteIsVariedCheckBox;
   QCheckBox *_specifiedSeedCheckBox;
   QSpinBox *_seedSpinBox;
+  QComboBox *_rngMethodComboBox;
 
   MethodGroupBox *_methodGroupBox;
 
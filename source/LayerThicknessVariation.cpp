@@ -133,14 +133,14 @@ void LayerThicknessVariation::reset() {
   setModel(Default);
 }
 
-auto LayerThicknessVariation::vary(double depthToBedrock) const
-    -> QList<double> {
+void LayerThicknessVariation::vary(double depthToBedrock,
+                                   QList<double> &thicknesses) const {
   // Need to convert the depth to bedrock into meters for the Toro (1997)
   // model.
   depthToBedrock *= Units::instance()->toMeters();
 
   // The thickness of the layers
-  QList<double> thicknesses;
+  thicknesses.clear();
 
   // The layering is generated using a non-homogenous Poisson process.  The
   // following routine is used to generate the layering.  The rate function,
@@ -180,8 +180,6 @@ auto LayerThicknessVariation::vary(double depthToBedrock) const
   // Convert the thicknesses back into the target unit system
   for (int i = 0; i < thicknesses.size(); ++i)
     thicknesses[i] /= Units::instance()->toMeters();
-
-  return thicknesses;
 }
 
 void LayerThicknessVariation::fromJson(const QJsonObject &json) {
@@ -70,7 +70,11 @@ public:
 
   void reset();
 
-  auto vary(double depthToBedrock) const -> QList<double>;
+  /*! Vary the layer thicknesses.
+   * \param depthToBedrock depth to the bedrock
+   * \param thicknesses set to the thicknesses, keeping its storage
+   */
+  void vary(double depthToBedrock, QList<double> &thicknesses) const;
 
   void fromJson(const QJsonObject &json);
   auto toJson() const -> QJsonObject;
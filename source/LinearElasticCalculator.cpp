@@ -31,6 +31,10 @@
 LinearElasticCalculator::LinearElasticCalculator(QObject *parent)
     : AbstractCalculator(parent) {}
 
+auto LinearElasticCalculator::duplicate() const -> AbstractCalculator * {
+  return new LinearElasticCalculator;
+}
+
 auto LinearElasticCalculator::run(AbstractMotion *motion, SoilProfile *site)
     -> bool {
   init(motion, site);
@@ -38,13 +42,13 @@ auto LinearElasticCalculator::run(AbstractMotion *motion, SoilProfile *site)
   // Complex shear modulus for all layers.
   // The shear modulus is constant over the frequency range.
   for (int i = 0; i < _nsl; ++i)
-    _shearMod[i].fill(
-        calcCompShearMod(_site->shearMod(i), _site->damping(i) / 100.));
+    _shearMod.fill(i, calcCompShearMod(_site->shearMod(i),
+                                       _site->damping(i) / 100.));
 
   // Compute the bedrock properties -- these do not change during the process.
   // The shear modulus is constant over the frequency range.
-  _shearMod[_nsl].fill(calcCompShearMod(_site->bedrock()->shearMod(),
-                                        _site->bedrock()->damping() / 100.));
+  _shearMod.fill(_nsl, calcCompShearMod(_site->bedrock()->shearMod(),
+                                         _site->bedrock()->damping() / 100.));
 
   // Compute upgoing and downgoing waves
   bool success = calcWaves();
@@ -32,6 +32,8 @@ public:
 
   virtual auto run(AbstractMotion *motion, SoilProfile *site) -> bool;
 
+  virtual auto duplicate() const -> AbstractCalculator *;
+
   //! Always converges
   virtual auto converged() const -> bool { return true; }
 };
@@ -27,6 +27,7 @@
 #include "EditActions.h"
 #include "GeneralPage.h"
 #include "HelpDialog.h"
+#include "MotionLibrary.h"
 #include "MotionPage.h"
 #include "NonlinearPropertyCatalogDialog.h"
 #include "OutputCatalog.h"
@@ -53,6 +54,7 @@
 #include <QScrollArea>
 #include <QStandardPaths>
 #include <QStatusBar>
+#include <QTimer>
 #include <QToolBar>
 #include <QVBoxLayout>
 
@@ -588,6 +590,10 @@ void MainWindow::setModel(SiteResponseModel *model) {
   connect(_model, &SiteResponseModel::fileNameChanged, this,
           &MainWindow::updateWindowTitle);
 
+  // The response spectra of the motions are only needed for display, so they
+  // are computed in the background once the window is shown
+  QTimer::singleShot(0, _model->motionLibrary(), &MotionLibrary::preprocess);
+
   connect(_model, &SiteResponseModel::started, this, &MainWindow::updateTabs);
   connect(_model, &SiteResponseModel::finished, this, &MainWindow::updateTabs);
 
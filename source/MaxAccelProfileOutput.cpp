@@ -47,15 +47,11 @@ void MaxAccelProfileOutput::extract(AbstractCalculator *const calculator,
   Q_UNUSED(ref);
 
   const AbstractMotion *motion = calculator->motion();
-  const SoilProfile *site = calculator->site();
 
-  // Outcrop for the first layer. Within for subsequent.
-  AbstractMotion::Type type = AbstractMotion::Outcrop;
+  const QVector<QVector<std::complex<double>>> &tfs =
+      calcAccelTfs(calculator);
 
-  for (const double &depth : this->ref()) {
-    data << motion->max(
-        calculator->calcAccelTf(site->inputLocation(), motion->type(),
-                                site->depthToLocation(depth), type));
-    type = AbstractMotion::Within;
-  }
+  data.reserve(tfs.size());
+  for (const QVector<std::complex<double>> &tf : std::as_const(tfs))
+    data << motion->max(tf);
 }
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MotionCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cstring>
+
+namespace {
+//! Changed whenever the layout or the processing of the entries changes
+const quint32 cacheVersion = 1;
+
+//! Total size of the entries kept in the cache in bytes
+const qint64 maxCacheSize = qint64(512) * 1024 * 1024;
+
+//! Header at the start of each entry, followed by the arrays
+struct Header {
+  char magic[8];
+  quint32 version;
+  //! Used to reject entries written with a different byte order
+  quint32 byteOrder;
+  qint32 pointCount;
+  qint32 stopLine;
+  qint32 accelSize;
+  qint32 fourierSize;
+  qint32 saSize;
+  qint32 reserved;
+  double pga;
+  double pgv;
+};
+
+static_assert(sizeof(Header) % sizeof(double) == 0,
+              "Arrays must be aligned to doubles");
+
+const char magic[8] = {'S', 'T', 'R', 'A', 'T', 'A', 'M', 'C'};
+const quint32 byteOrder = 0x01020304;
+
+auto fileName(const QByteArray &key) -> QString {
+  return QDir(MotionCache::directory())
+      .absoluteFilePath(QString::fromLatin1(key) + ".bin");
+}
+
+//! Copy an array from the entry and advance the position
+template <typename T>
+void readArray(const char **pos, int size, QVector<T> &vector) {
+  vector.resize(size);
+  if (size)
+    memcpy(vector.data(), *pos, sizeof(T) * size);
+  *pos += sizeof(T) * size;
+}
+
+template <typename T>
+void writeArray(QSaveFile &file, const QVector<T> &vector) {
+  file.write(reinterpret_cast<const char *>(vector.constData()),
+             sizeof(T) * vector.size());
+}
+
+//! Remove the least recently used entries beyond maxCacheSize
+void prune() {
+  // Sorted from the most to the least recently used
+  const QFileInfoList infos = QDir(MotionCache::directory())
+                                  .entryInfoList({"*.bin"}, QDir::Files,
+                                                 QDir::Time);
+  qint64 total = 0;
+  for (const QFileInfo &info : infos) {
+    total += info.size();
+    // Fails if the entry is in use, in which case it is removed later
+    if (total > maxCacheSize)
+      QFile::remove(info.absoluteFilePath());
+  }
+}
+} // namespace
+
+auto MotionCache::directory() -> QString {
+  return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+      .absoluteFilePath("motions");
+}
+
+auto MotionCache::key(const QString &fileName, const QByteArray &settings)
+    -> QByteArray {
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  if (!hash.addData(&file))
+    return QByteArray();
+
+  hash.addData(settings);
+  hash.addData(QByteArray::number(cacheVersion));
+
+  return hash.result().toHex();
+}
+
+auto MotionCache::read(const QByteArray &key, Entry *entry) -> bool {
+  QFile file(fileName(key));
+  if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header)))
+    return false;
+
+  // Read from a map of the file, or from a copy if it cannot be mapped
+  QByteArray contents;
+  const char *data = reinterpret_cast<const char *>(file.map(0, file.size()));
+  if (!data) {
+    contents = file.readAll();
+    data = contents.constData();
+  }
+
+  Header header;
+  memcpy(&header, data, sizeof(Header));
+
+  if (memcmp(header.magic, magic, sizeof(magic)) ||
+      header.version != cacheVersion || header.byteOrder != byteOrder ||
+      header.accelSize < 0 || header.fourierSize < 0 || header.saSize < 0)
+    return false;
+
+  const qint64 expectedSize =
+      sizeof(Header) +
+      sizeof(double) * (qint64(header.accelSize) + 4 * header.fourierSize +
+                        header.saSize);
+  if (file.size() != expectedSize) {
+    qWarning() << "Ignoring invalid motion cache entry:" << file.fileName();
+    return false;
+  }
+
+  entry->pointCount = header.pointCount;
+  entry->stopLine = header.stopLine;
+  entry->pga = header.pga;
+  entry->pgv = header.pgv;
+
+  const char *pos = data + sizeof(Header);
+  readArray(&pos, header.accelSize, entry->accel);
+  readArray(&pos, header.fourierSize, entry->fourierAcc);
+  readArray(&pos, header.fourierSize, entry->fourierVel);
+  readArray(&pos, header.saSize, entry->sa);
+
+  // Mark the entry as recently used so that it is kept by prune()
+  file.setFileTime(QDateTime::currentDateTimeUtc(),
+                   QFileDevice::FileModificationTime);
+
+  return true;
+}
+
+auto MotionCache::write(const QByteArray &key, const Entry &entry) -> bool {
+  Q_ASSERT(entry.fourierAcc.size() == entry.fourierVel.size());
+
+  if (!QDir().mkpath(directory()))
+    return false;
+
+  QSaveFile file(fileName(key));
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  memcpy(header.magic, magic, sizeof(magic));
+  header.version = cacheVersion;
+  header.byteOrder = byteOrder;
+  header.pointCount = entry.pointCount;
+  header.stopLine = entry.stopLine;
+  header.accelSize = entry.accel.size();
+  header.fourierSize = entry.fourierAcc.size();
+  header.saSize = entry.sa.size();
+  header.pga = entry.pga;
+  header.pgv = entry.pgv;
+
+  file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  writeArray(file, entry.accel);
+  writeArray(file, entry.fourierAcc);
+  writeArray(file, entry.fourierVel);
+  writeArray(file, entry.sa);
+
+  if (!file.commit())
+    return false;
+
+  prune();
+  return true;
+}
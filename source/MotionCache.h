@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOTION_CACHE_H
+#define MOTION_CACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <complex>
+
+/*! On-disk cache of the properties computed from time series files.
+ *
+ * Each entry is keyed by the hash of the file contents and of the settings
+ * used to read and process it, so editing the file or the settings creates a
+ * new entry. An entry is a fixed header followed by the arrays of doubles,
+ * all aligned to 8 bytes, which are copied from a memory map of the file.
+ *
+ * Entries left behind by edited files are never read again, so the least
+ * recently used entries are removed once the cache exceeds 512 MB.
+ */
+class MotionCache {
+public:
+  //! Properties of a processed time series
+  struct Entry {
+    //! Point count and stop line after the file was read
+    qint32 pointCount;
+    qint32 stopLine;
+
+    double pga;
+    double pgv;
+
+    QVector<double> accel;
+    QVector<std::complex<double>> fourierAcc;
+    QVector<std::complex<double>> fourierVel;
+
+    //! Spectral acceleration of the response spectrum
+    QVector<double> sa;
+  };
+
+  //! Directory used to store the entries
+  static auto directory() -> QString;
+
+  /*! Key of a file and the settings used to process it
+   *
+   * \param fileName path to the time series file
+   * \param settings serialized settings that change the processed values
+   * \return the key, or an empty array if the file cannot be read
+   */
+  static auto key(const QString &fileName, const QByteArray &settings)
+      -> QByteArray;
+
+  //! Read an entry, returns false if it does not exist or is invalid
+  static auto read(const QByteArray &key, Entry *entry) -> bool;
+
+  //! Save an entry. Entries are written to a temporary file and renamed, so
+  //! they may be saved from several threads. Old entries are then pruned.
+  static auto write(const QByteArray &key, const Entry &entry) -> bool;
+};
+
+#endif // MOTION_CACHE_H
@@ -30,15 +30,59 @@
 #include <QBrush>
 #include <QColor>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QJsonArray>
 #include <QJsonValue>
+#include <QLoggingCategory>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+// Load times of the motions are reported with
+// QT_LOGGING_RULES="strata.motions.debug=true"
+Q_LOGGING_CATEGORY(lcMotions, "strata.motions", QtInfoMsg)
+
+namespace {
+/*! Load the motion from JSON on the thread pool.
+ *
+ * The motion must already be created on the calling thread, so that it is
+ * owned by the library. The task only modifies the motion itself.
+ *
+ * \param pool thread pool used for the task
+ * \param motion motion to load
+ * \param json JSON object describing the motion
+ * \param elapsed set to the time required to load the motion in ms
+ */
+template <class T>
+void startLoad(QThreadPool *pool, T *motion, const QJsonObject &json,
+               qint64 *elapsed) {
+  pool->start([motion, json, elapsed]() {
+    QElapsedTimer timer;
+    timer.start();
+    motion->fromJson(json);
+    *elapsed = timer.elapsed();
+  });
+}
+} // namespace
 
 MotionLibrary::MotionLibrary(QObject *parent) : MyAbstractTableModel(parent) {
   _approach = TimeSeries;
   _saveData = true;
+  _responseSpectrumMethod = TimeSeriesMotion::FrequencyDomain;
+  _peakFactorMethod = VanmarckePeakCalculator::Integration;
 
+  // Connected before the motions are created, so that the background
+  // calculations are finished before the motions are updated
   connect(Units::instance(), &Units::systemChanged, this,
           &MotionLibrary::updateUnits);
+
+  connect(&_preprocessWatcher, &QFutureWatcher<void>::finished, this,
+          &MotionLibrary::applyPreprocess);
+}
+
+MotionLibrary::~MotionLibrary() {
+  // The tasks must finish before the motions are deleted
+  _preprocessWatcher.cancel();
+  _preprocessWatcher.waitForFinished();
 }
 
 auto MotionLibrary::approachList() -> QStringList {
@@ -89,6 +133,56 @@ void MotionLibrary::setSaveData(bool b) {
 
 auto MotionLibrary::saveData() const -> bool { return _saveData; }
 
+auto MotionLibrary::responseSpectrumMethod() const
+    -> TimeSeriesMotion::ResponseSpectrumMethod {
+  return _responseSpectrumMethod;
+}
+
+void MotionLibrary::setResponseSpectrumMethod(
+    TimeSeriesMotion::ResponseSpectrumMethod method) {
+  if (_responseSpectrumMethod != method) {
+    waitForPreprocess();
+    _responseSpectrumMethod = method;
+    emit responseSpectrumMethodChanged(_responseSpectrumMethod);
+    emit wasModified();
+
+    for (auto *m : std::as_const(_motions)) {
+      if (auto *tsm = qobject_cast<TimeSeriesMotion *>(m)) {
+        tsm->setResponseSpectrumMethod(method);
+      }
+    }
+  }
+}
+
+void MotionLibrary::setResponseSpectrumMethod(int method) {
+  setResponseSpectrumMethod((TimeSeriesMotion::ResponseSpectrumMethod)method);
+}
+
+auto MotionLibrary::peakFactorMethod() const
+    -> VanmarckePeakCalculator::PeakFactorMethod {
+  return _peakFactorMethod;
+}
+
+void MotionLibrary::setPeakFactorMethod(
+    VanmarckePeakCalculator::PeakFactorMethod method) {
+  if (_peakFactorMethod != method) {
+    waitForPreprocess();
+    _peakFactorMethod = method;
+    emit peakFactorMethodChanged(_peakFactorMethod);
+    emit wasModified();
+
+    for (auto *m : std::as_const(_motions)) {
+      if (auto *arm = qobject_cast<AbstractRvtMotion *>(m)) {
+        arm->setPeakFactorMethod(method);
+      }
+    }
+  }
+}
+
+void MotionLibrary::setPeakFactorMethod(int method) {
+  setPeakFactorMethod((VanmarckePeakCalculator::PeakFactorMethod)method);
+}
+
 auto MotionLibrary::rowCount(const QModelIndex &parent) const -> int {
   Q_UNUSED(parent);
   return _motions.size();
@@ -197,6 +291,8 @@ auto MotionLibrary::setData(const QModelIndex &index, const QVariant &value,
   if (index.parent() != QModelIndex() || _readOnly)
     return false;
 
+  waitForPreprocess();
+
   if (role == Qt::EditRole) {
     switch (index.column()) {
     case NameColumn:
@@ -243,6 +339,8 @@ auto MotionLibrary::removeRows(int row, int count, const QModelIndex &parent)
     -> bool {
   if (!count)
     return false;
+
+  waitForPreprocess();
   beginRemoveRows(parent, row, row + count - 1);
 
   for (int i = 0; i < count; ++i) {
@@ -268,8 +366,12 @@ void MotionLibrary::addMotion(AbstractMotion *motion) {
   int row = rowCount();
   motion->setParent(this);
 
-  if (auto *tsm = qobject_cast<TimeSeriesMotion *>(motion))
+  if (auto *tsm = qobject_cast<TimeSeriesMotion *>(motion)) {
     tsm->setSaveData(_saveData);
+    tsm->setResponseSpectrumMethod(_responseSpectrumMethod);
+  } else if (auto *arm = qobject_cast<AbstractRvtMotion *>(motion)) {
+    arm->setPeakFactorMethod(_peakFactorMethod);
+  }
 
   beginInsertRows(QModelIndex(), row, row);
   _motions.insert(row, motion);
@@ -311,46 +413,130 @@ void MotionLibrary::setReadOnly(bool readOnly) {
 }
 
 void MotionLibrary::updateUnits() {
+  waitForPreprocess();
   emit headerDataChanged(Qt::Horizontal, PgvColumn, PgvColumn);
 }
 
+void MotionLibrary::preprocess() {
+  waitForPreprocess();
+
+  for (AbstractMotion *motion : std::as_const(_motions)) {
+    if (motion->respSpecIsStale())
+      _preprocessItems << PreprocessItem{motion, QVector<double>()};
+  }
+
+  if (_preprocessItems.isEmpty())
+    return;
+
+  // Each task only uses its own motion. The spectra are applied on this
+  // thread, since the response spectrum models may be shown in a view.
+  _preprocessWatcher.setFuture(
+      QtConcurrent::map(_preprocessItems, [](PreprocessItem &item) {
+        item.sa = item.motion->calculateRespSpec();
+      }));
+}
+
+void MotionLibrary::waitForPreprocess() {
+  if (_preprocessItems.isEmpty())
+    return;
+
+  _preprocessWatcher.cancel();
+  _preprocessWatcher.waitForFinished();
+  applyPreprocess();
+}
+
+void MotionLibrary::applyPreprocess() {
+  // The spectra may have already been applied by waitForPreprocess()
+  if (_preprocessItems.isEmpty() || !_preprocessWatcher.isFinished())
+    return;
+
+  const QVector<PreprocessItem> items = _preprocessItems;
+  _preprocessItems.clear();
+
+  for (const PreprocessItem &item : items) {
+    if (!item.sa.isEmpty() && item.motion->respSpecIsStale())
+      item.motion->setRespSpecSa(item.sa);
+  }
+}
+
 void MotionLibrary::fromJson(const QJsonObject &json) {
   int approach = json["approach"].toInt();
   setApproach(approach);
   bool saveData = json["saveData"].toBool();
   setSaveData(saveData);
+  setResponseSpectrumMethod(json["responseSpectrumMethod"].toInt());
+  setPeakFactorMethod(json["peakFactorMethod"].toInt());
 
+  waitForPreprocess();
   beginResetModel();
 
   while (_motions.size())
     _motions.takeLast()->deleteLater();
 
+  QElapsedTimer timer;
+  timer.start();
+
+  // The motions are created here and loaded in parallel. Time series are
+  // read and transformed, and compatible motions are fit to their target,
+  // so the loading dominates the time required to open a project.
   const QJsonArray motions = json["motions"].toArray();
-  for (const QJsonValue &value : motions) {
-    QJsonObject mjo = value.toObject();
-    QString className = mjo["className"].toString();
+  QVector<AbstractMotion *> loaded(motions.size(), nullptr);
+  QVector<qint64> elapsed(motions.size(), 0);
+  QThreadPool pool;
+
+  for (int i = 0; i < motions.size(); ++i) {
+    const QJsonObject mjo = motions.at(i).toObject();
+    const QString className = mjo["className"].toString();
+    qint64 *time = elapsed.data() + i;
 
     if (className == "TimeSeriesMotion") {
       auto *m = new TimeSeriesMotion(this);
-      qobject_cast<TimeSeriesMotion *>(m)->fromJson(mjo);
-      qobject_cast<TimeSeriesMotion *>(m)->setSaveData(_saveData);
-      _motions << m;
+      // The method is part of the cache key used while loading
+      m->setResponseSpectrumMethod(_responseSpectrumMethod);
+      startLoad(&pool, m, mjo, time);
+      loaded[i] = m;
     } else if (className == "RvtMotion") {
       auto *m = new RvtMotion(this);
-      qobject_cast<RvtMotion *>(m)->fromJson(mjo);
-      _motions << m;
+      startLoad(&pool, m, mjo, time);
+      loaded[i] = m;
     } else if (className == "CompatibleRvtMotion") {
       auto *m = new CompatibleRvtMotion(this);
-      qobject_cast<CompatibleRvtMotion *>(m)->fromJson(mjo);
-      _motions << m;
+      startLoad(&pool, m, mjo, time);
+      loaded[i] = m;
     } else if (className == "SourceTheoryRvtMotion") {
       auto *m = new SourceTheoryRvtMotion(this);
-      qobject_cast<SourceTheoryRvtMotion *>(m)->fromJson(mjo);
-      _motions << m;
+      startLoad(&pool, m, mjo, time);
+      loaded[i] = m;
     } else {
       qCritical("className '%s' not recognized!", qPrintable(className));
     }
   }
+  pool.waitForDone();
+
+  // Add the motions in the order of the file
+  for (int i = 0; i < loaded.size(); ++i) {
+    AbstractMotion *m = loaded.at(i);
+    if (!m)
+      continue;
+
+    // The motion reads its own saveData to find the embedded samples, so
+    // the setting of the library is applied once it is loaded
+    if (auto *tsm = qobject_cast<TimeSeriesMotion *>(m))
+      tsm->setSaveData(_saveData);
+    _motions << m;
+
+    qCDebug(lcMotions).noquote()
+        << "Loaded" << m->name() << "in" << elapsed.at(i) << "ms";
+  }
+
+  qCDebug(lcMotions) << "Loaded" << _motions.size() << "motions in"
+                     << timer.elapsed() << "ms using"
+                     << pool.maxThreadCount() << "threads";
+
+  for (auto *m : std::as_const(_motions)) {
+    if (auto *arm = qobject_cast<AbstractRvtMotion *>(m))
+      arm->setPeakFactorMethod(_peakFactorMethod);
+  }
 
   endResetModel();
 }
@@ -386,6 +572,8 @@ auto MotionLibrary::toJson() const -> QJsonObject {
   QJsonObject json;
   json["approach"] = (int)_approach;
   json["saveData"] = _saveData;
+  json["responseSpectrumMethod"] = (int)_responseSpectrumMethod;
+  json["peakFactorMethod"] = (int)_peakFactorMethod;
 
   QJsonArray motions;
 
@@ -414,9 +602,11 @@ auto MotionLibrary::toJson() const -> QJsonObject {
 }
 
 auto operator<<(QDataStream &out, const MotionLibrary *ml) -> QDataStream & {
-  out << (quint8)1;
+  out << (quint8)3;
 
   out << (qint32)ml->_approach << ml->_saveData << (quint32)ml->_motions.size();
+  out << (qint32)ml->_responseSpectrumMethod;
+  out << (qint32)ml->_peakFactorMethod;
 
   for (auto *m : ml->_motions) {
     const QString &className = m->metaObject()->className();
@@ -449,6 +639,19 @@ auto operator>>(QDataStream &in, MotionLibrary *ml) -> QDataStream & {
   ml->setApproach(approach);
   ml->setSaveData(saveData);
 
+  if (ver > 1) {
+    qint32 method;
+    in >> method;
+    ml->setResponseSpectrumMethod(method);
+  }
+
+  if (ver > 2) {
+    qint32 method;
+    in >> method;
+    ml->setPeakFactorMethod(method);
+  }
+
+  ml->waitForPreprocess();
   ml->beginResetModel();
   QString className;
 
@@ -457,6 +660,7 @@ auto operator>>(QDataStream &in, MotionLibrary *ml) -> QDataStream & {
     if (className == "TimeSeriesMotion") {
       auto *m = new TimeSeriesMotion(ml);
       m->setSaveData(ml->_saveData);
+      m->setResponseSpectrumMethod(ml->_responseSpectrumMethod);
       in >> m;
 
       if (m->accel().size()) {
@@ -483,6 +687,11 @@ auto operator>>(QDataStream &in, MotionLibrary *ml) -> QDataStream & {
     }
   }
 
+  for (auto *m : std::as_const(ml->_motions)) {
+    if (auto *arm = qobject_cast<AbstractRvtMotion *>(m))
+      arm->setPeakFactorMethod(ml->_peakFactorMethod);
+  }
+
   ml->endResetModel();
 
   return in;
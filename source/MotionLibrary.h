@@ -23,9 +23,12 @@
 #define MOTION_LIBRARY_H
 
 #include "AbstractMotion.h"
+#include "AbstractRvtMotion.h"
 #include "MyAbstractTableModel.h"
+#include "TimeSeriesMotion.h"
 
 #include <QDataStream>
+#include <QFutureWatcher>
 #include <QJsonObject>
 
 class MotionLibrary : public MyAbstractTableModel {
@@ -37,6 +40,7 @@ class MotionLibrary : public MyAbstractTableModel {
 
 public:
   explicit MotionLibrary(QObject *parent = nullptr);
+  ~MotionLibrary();
 
   //! Table columns
   enum Column {
@@ -79,6 +83,14 @@ public:
 
   auto saveData() const -> bool;
 
+  auto responseSpectrumMethod() const
+      -> TimeSeriesMotion::ResponseSpectrumMethod;
+  void
+  setResponseSpectrumMethod(TimeSeriesMotion::ResponseSpectrumMethod method);
+
+  auto peakFactorMethod() const -> VanmarckePeakCalculator::PeakFactorMethod;
+  void setPeakFactorMethod(VanmarckePeakCalculator::PeakFactorMethod method);
+
   //! Number of enabled motions
   auto motionCount() const -> int;
 
@@ -97,19 +109,42 @@ public:
   void fromJson(const QJsonObject &json);
   auto toJson() const -> QJsonObject;
 
+  /*! Wait for the response spectra computed by preprocess().
+   *
+   * Spectra that have not been started are skipped, and are computed when
+   * they are accessed. Must be called before the motions are modified,
+   * deleted, or used in a calculation.
+   */
+  void waitForPreprocess();
+
 signals:
   void wasModified();
   void approachChanged(int approach);
   void saveDataChanged(bool saveData);
+  void responseSpectrumMethodChanged(int method);
+  void peakFactorMethodChanged(int method);
 
 public slots:
   void setSaveData(bool b);
   void setApproach(int approach);
+  void setResponseSpectrumMethod(int method);
+  void setPeakFactorMethod(int method);
   virtual void setReadOnly(bool readOnly);
 
+  /*! Compute the response spectra of the motions in the background.
+   *
+   * The response spectra are otherwise computed when they are first
+   * accessed. The spectra of the motions are computed in parallel, and are
+   * applied once all of them are finished.
+   */
+  void preprocess();
+
 protected slots:
   void updateUnits();
 
+  //! Apply the spectra computed by preprocess()
+  void applyPreprocess();
+
 protected:
   //! Approach used to characterize input motions
   Approach _approach;
@@ -118,8 +153,24 @@ protected:
   //! time series
   bool _saveData;
 
+  //! Method used by the time series motions to compute response spectra
+  TimeSeriesMotion::ResponseSpectrumMethod _responseSpectrumMethod;
+
+  //! Method used by the RVT motions to compute peak factors
+  VanmarckePeakCalculator::PeakFactorMethod _peakFactorMethod;
+
   //! List of motions
   QList<AbstractMotion *> _motions;
+
+  //! Response spectrum computed by preprocess()
+  struct PreprocessItem {
+    AbstractMotion *motion;
+    QVector<double> sa;
+  };
+
+  //! Motions being processed, the spectra are only set by the tasks
+  QVector<PreprocessItem> _preprocessItems;
+  QFutureWatcher<void> _preprocessWatcher;
 };
 
 #endif // MOTION_LIBRARY_H
@@ -166,6 +166,8 @@ void MotionPage::add() {
   case MotionLibrary::TimeSeries: {
     auto *_motion = new TimeSeriesMotion(_motionLibrary);
     _motion->setSaveData(_motionLibrary->saveData());
+    _motion->setResponseSpectrumMethod(
+        _motionLibrary->responseSpectrumMethod());
 
     dialog = (QDialog *)(new TimeSeriesMotionDialog(_motion, _readOnly, this));
     motion = (AbstractMotion *)_motion;
@@ -213,6 +215,9 @@ void MotionPage::add() {
   }
   }
 
+  if (auto *arm = qobject_cast<AbstractRvtMotion *>(motion))
+    arm->setPeakFactorMethod(_motionLibrary->peakFactorMethod());
+
   if (dialog->exec()) {
     _motionLibrary->addMotion(motion);
     _tableView->resizeColumnsToContents();
@@ -331,6 +336,9 @@ void MotionPage::edit() {
   const QModelIndex &index = _tableView->currentIndex();
   AbstractMotion *motion = _motionLibrary->motionAt(index.row());
 
+  // The dialog shows the response spectrum and may modify the motion
+  _motionLibrary->waitForPreprocess();
+
   // Buffer to save the state of the motion
   QBuffer buffer;
   buffer.open(QBuffer::ReadWrite);
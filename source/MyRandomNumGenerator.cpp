@@ -25,14 +25,128 @@
 #include <QDateTime>
 #include <QDebug>
 
+namespace {
+/* State of a stream generator. The stream either forwards to a shared
+ * generator (sequential method), or computes the Philox4x32-10 block cipher
+ * of a counter (counter-based method), see Salmon et al. (2011) "Parallel
+ * random numbers: as easy as 1, 2, 3".
+ */
+struct StreamState {
+  //! Generator used by the sequential method, nullptr otherwise
+  gsl_rng *shared;
+
+  //! Key: seed and stream index
+  quint32 key[2];
+
+  //! Counter: block index (two words), realization, and unused
+  quint32 counter[4];
+
+  //! Output of the last block
+  quint32 block[4];
+
+  //! Position of the next value in the block
+  int position;
+};
+
+void philox4x32(const quint32 *counter, const quint32 *key, quint32 *out) {
+  const quint64 M0 = 0xD2511F53;
+  const quint64 M1 = 0xCD9E8D57;
+  const quint32 W0 = 0x9E3779B9;
+  const quint32 W1 = 0xBB67AE85;
+
+  quint32 c[4] = {counter[0], counter[1], counter[2], counter[3]};
+  quint32 k[2] = {key[0], key[1]};
+
+  for (int round = 0; round < 10; ++round) {
+    if (round > 0) {
+      k[0] += W0;
+      k[1] += W1;
+    }
+
+    const quint64 p0 = M0 * c[0];
+    const quint64 p1 = M1 * c[2];
+
+    const quint32 next[4] = {
+        static_cast<quint32>(p1 >> 32) ^ c[1] ^ k[0],
+        static_cast<quint32>(p1),
+        static_cast<quint32>(p0 >> 32) ^ c[3] ^ k[1],
+        static_cast<quint32>(p0),
+    };
+
+    for (int i = 0; i < 4; ++i)
+      c[i] = next[i];
+  }
+
+  for (int i = 0; i < 4; ++i)
+    out[i] = c[i];
+}
+
+void streamSet(void *vstate, unsigned long int seed) {
+  auto *state = static_cast<StreamState *>(vstate);
+
+  state->shared = nullptr;
+  state->key[0] = static_cast<quint32>(seed);
+  state->key[1] = 0;
+  for (int i = 0; i < 4; ++i)
+    state->counter[i] = 0;
+  // Force a new block on the next call
+  state->position = 4;
+}
+
+auto streamGet(void *vstate) -> unsigned long int {
+  auto *state = static_cast<StreamState *>(vstate);
+
+  if (state->shared)
+    return gsl_rng_get(state->shared);
+
+  if (state->position == 4) {
+    philox4x32(state->counter, state->key, state->block);
+    state->position = 0;
+
+    // Increment the block index
+    if (++state->counter[0] == 0)
+      ++state->counter[1];
+  }
+
+  return state->block[state->position++];
+}
+
+auto streamGetDouble(void *vstate) -> double {
+  auto *state = static_cast<StreamState *>(vstate);
+
+  if (state->shared)
+    return gsl_rng_uniform(state->shared);
+
+  return streamGet(vstate) / 4294967296.0;
+}
+
+const gsl_rng_type streamType = {"strata_stream",     0xffffffffUL,
+                                 0,                   sizeof(StreamState),
+                                 &streamSet,          &streamGet,
+                                 &streamGetDouble};
+} // namespace
+
 MyRandomNumGenerator::MyRandomNumGenerator(QObject *parent)
-    : QObject(parent), _seedSpecified(false), _seed(0) {
+    : QObject(parent), _seedSpecified(false), _seed(0), _method(Sequential) {
   _gsl_rng = gsl_rng_alloc(gsl_rng_mt19937);
+  for (int i = 0; i < StreamCount; ++i)
+    _streams << gsl_rng_alloc(&streamType);
+
   _seedSpecified = false;
   init();
 }
 
-MyRandomNumGenerator::~MyRandomNumGenerator() { gsl_rng_free(_gsl_rng); }
+MyRandomNumGenerator::~MyRandomNumGenerator() {
+  for (gsl_rng *stream : std::as_const(_streams))
+    gsl_rng_free(stream);
+
+  gsl_rng_free(_gsl_rng);
+}
+
+auto MyRandomNumGenerator::methodList() -> QStringList {
+  return {tr("Sequential (Mersenne twister)"),
+          tr("Counter-based (per realization)")};
+}
 
 auto MyRandomNumGenerator::seedSpecified() const -> bool {
   return _seedSpecified;
@@ -40,7 +154,26 @@ auto MyRandomNumGenerator::seedSpecified() const -> bool {
 
 auto MyRandomNumGenerator::seed() const -> quint32 { return _seed; }
 
-auto MyRandomNumGenerator::gsl_pointer() -> gsl_rng * { return _gsl_rng; }
+auto MyRandomNumGenerator::method() const -> MyRandomNumGenerator::Method {
+  return _method;
+}
+
+void MyRandomNumGenerator::setMethod(Method method) {
+  if (_method != method) {
+    _method = method;
+
+    emit methodChanged(_method);
+    emit wasModified();
+  }
+}
+
+void MyRandomNumGenerator::setMethod(int method) {
+  setMethod(static_cast<Method>(method));
+}
+
+auto MyRandomNumGenerator::gsl_pointer(Stream stream) -> gsl_rng * {
+  return _streams.at(stream);
+}
 
 void MyRandomNumGenerator::setSeedSpecified(bool seedSpecified) {
   if (_seedSpecified != seedSpecified) {
@@ -66,25 +199,53 @@ void MyRandomNumGenerator::init() {
     setSeed(1 + rand() % 65534);
   }
   gsl_rng_set(_gsl_rng, _seed);
+
+  for (int i = 0; i < _streams.size(); ++i) {
+    auto *state = static_cast<StreamState *>(_streams.at(i)->state);
+    streamSet(state, _seed);
+    state->key[1] = static_cast<quint32>(i);
+
+    if (_method == Sequential)
+      state->shared = _gsl_rng;
+  }
+
+  setRealization(0);
+}
+
+void MyRandomNumGenerator::setRealization(quint32 realization) {
+  if (_method != CounterBased)
+    return;
+
+  for (gsl_rng *stream : std::as_const(_streams)) {
+    auto *state = static_cast<StreamState *>(stream->state);
+    state->counter[0] = 0;
+    state->counter[1] = 0;
+    state->counter[2] = realization;
+    state->counter[3] = 0;
+    state->position = 4;
+  }
 }
 
 void MyRandomNumGenerator::fromJson(const QJsonObject &json) {
   _seedSpecified = json["seedSpecified"].toBool();
   _seed = (quint32)json["seed"].toInt();
+  _method = (MyRandomNumGenerator::Method)json["method"].toInt(Sequential);
 }
 
 auto MyRandomNumGenerator::toJson() const -> QJsonObject {
   QJsonObject json;
   json["seedSpecified"] = _seedSpecified;
   json["seed"] = (int)_seed;
+  json["method"] = (int)_method;
   return json;
 }
 
 auto operator<<(QDataStream &out, const MyRandomNumGenerator *myGenerator)
     -> QDataStream & {
-  out << (quint8)1;
+  out << (quint8)2;
 
-  out << myGenerator->_seedSpecified << myGenerator->_seed;
+  out << myGenerator->_seedSpecified << myGenerator->_seed
+      << (qint32)myGenerator->_method;
 
   return out;
 }
@@ -96,5 +257,11 @@ auto operator>>(QDataStream &in, MyRandomNumGenerator *myGenerator)
 
   in >> myGenerator->_seedSpecified >> myGenerator->_seed;
 
+  if (version > 1) {
+    qint32 method;
+    in >> method;
+    myGenerator->_method = (MyRandomNumGenerator::Method)method;
+  }
+
   return in;
 }
@@ -27,6 +27,7 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include <gsl/gsl_rng.h>
 
@@ -43,12 +44,49 @@ public:
   MyRandomNumGenerator(QObject *parent = nullptr);
   ~MyRandomNumGenerator();
 
+  //! Method used to generate the random numbers
+  enum Method {
+    //! A single Mersenne twister shared by all of the random variables. Each
+    //! realization depends on all of the previous realizations.
+    Sequential,
+    //! Counter-based (Philox4x32-10) streams keyed by the seed, realization,
+    //! and random variable. Each realization can be generated independently.
+    CounterBased
+  };
+
+  static auto methodList() -> QStringList;
+
+  //! Independent streams of random numbers
+  enum Stream {
+    NonlinearPropertyStream, //!< Nonlinear properties and bedrock damping
+    BedrockDepthStream,      //!< Depth to bedrock
+    LayerThicknessStream,    //!< Layer thickness
+    VelocityStream,          //!< Shear-wave velocity
+    StreamCount
+  };
+
   auto seedSpecified() const -> bool;
 
   auto seed() const -> quint32;
   void setSeed(quint32 seed);
 
-  auto gsl_pointer() -> gsl_rng *;
+  auto method() const -> Method;
+  void setMethod(Method method);
+
+  /*! Generator used for a random variable.
+   *
+   * The pointer stays valid for the life of the object, regardless of the
+   * method. For the sequential method, all streams draw from the same
+   * generator.
+   */
+  auto gsl_pointer(Stream stream) -> gsl_rng *;
+
+  /*! Position the streams at the start of a realization.
+   *
+   * Only has an effect for the counter-based method, where the random
+   * numbers of a realization only depend on the seed and \a realization.
+   */
+  void setRealization(quint32 realization);
 
   void fromJson(const QJsonObject &json);
   auto toJson() const -> QJsonObject;
@@ -56,18 +94,26 @@ public:
 public slots:
   void setSeedSpecified(bool seedSpecified);
   void setSeed(int seed);
+  void setMethod(int method);
 
   void init();
 
 signals:
   void seedSpecifiedChanged(int seedType);
   void seedChanged(int seed);
+  void methodChanged(int method);
   void wasModified();
 
 protected:
   bool _seedSpecified;
   quint32 _seed;
 
+  Method _method;
+
+  //! Mersenne twister used by the sequential method
   gsl_rng *_gsl_rng;
+
+  //! Generators of each of the streams
+  QVector<gsl_rng *> _streams;
 };
 #endif
@@ -34,10 +34,7 @@
 #include <cmath>
 
 NonlinearProperty::NonlinearProperty(QObject *parent)
-    : QAbstractTableModel(parent) {
-  _interp = nullptr;
-  _acc = gsl_interp_accel_alloc();
-}
+    : QAbstractTableModel(parent) {}
 
 NonlinearProperty::NonlinearProperty(const QString &name, Type type,
                                      const QVector<double> &strain,
@@ -45,21 +42,11 @@ NonlinearProperty::NonlinearProperty(const QString &name, Type type,
                                      QObject *parent)
     : QAbstractTableModel(parent), _name(name), _type(type), _strain(strain),
       _average(property) {
-  _interp = nullptr;
-  _acc = gsl_interp_accel_alloc();
-
   // Set the *varied* property, and calculate the lnStrain values
   setVaried(property);
 }
 
-NonlinearProperty::~NonlinearProperty() {
-  gsl_interp_accel_free(_acc);
-
-  if (_interp) {
-    gsl_interp_free(_interp);
-    _interp = nullptr;
-  }
-}
+NonlinearProperty::~NonlinearProperty() {}
 
 auto NonlinearProperty::type() const -> NonlinearProperty::Type {
   return _type;
@@ -67,23 +54,45 @@ auto NonlinearProperty::type() const -> NonlinearProperty::Type {
 
 auto NonlinearProperty::name() const -> const QString & { return _name; }
 
-auto NonlinearProperty::interp(const double strain) -> double {
-  double d;
+auto NonlinearProperty::interp(const double strain) const -> double {
   if (strain < _strain.first()) {
-    d = _varied.first();
-  } else if (strain > _strain.last()) {
-    d = _varied.last();
-  } else if (_strain.size() == 1) {
-    // Interpolater won't be intialized
-    d = _varied.first();
-  } else {
-    if (!_interp)
-      initialize();
-    d = gsl_interp_eval(_interp, _lnStrain.data(), _varied.data(), log(strain),
-                        _acc);
+    return _varied.first();
+  } else if (strain > _strain.last() || _strain.size() == 1) {
+    return _varied.last();
   }
 
-  return d;
+  // Linear interpolation in log-strain space. The evaluation is done without
+  // any shared state (e.g., a GSL accelerator) so that the property can be
+  // queried from multiple threads.
+  const double x = log(strain);
+  const int i = segment(x);
+
+  return _varied.at(i) + _slope.at(i) * (x - _lnStrain.at(i));
+}
+
+void NonlinearProperty::interp(const QVector<double> &strains,
+                               QVector<double> &props) const {
+  props.resize(strains.size());
+  double *p = props.data();
+  for (int i = 0; i < strains.size(); ++i) {
+    p[i] = interp(strains.at(i));
+  }
+}
+
+auto NonlinearProperty::segment(double lnStrain) const -> int {
+  // Binary search for the last segment start that is not greater than the
+  // strain. The number of steps only depends on the number of segments and
+  // the comparison compiles to a conditional move, so the search is free of
+  // unpredictable branches.
+  const double *first = _lnStrain.constData();
+  const double *base = first;
+  int len = _lnStrain.size() - 1;
+  while (len > 1) {
+    const int half = len / 2;
+    base += (base[half] <= lnStrain) ? half : 0;
+    len -= half;
+  }
+  return int(base - first);
 }
 
 auto NonlinearProperty::toHtml() const -> QString {
@@ -215,21 +224,11 @@ void NonlinearProperty::setVaried(const QVector<double> &varied) {
     _lnStrain << log(s);
   }
 
-  // Free the interpolator and reset the pointer to zero
-  if (_interp) {
-    gsl_interp_free(_interp);
-    _interp = nullptr;
-  }
-}
-
-void NonlinearProperty::initialize() {
-  if (_lnStrain.size() > 1) {
-    if (_interp)
-      gsl_interp_free(_interp);
-    _interp = gsl_interp_alloc(gsl_interp_linear, _lnStrain.size());
-    gsl_interp_init(_interp, _lnStrain.data(), _varied.data(),
-                    _lnStrain.size());
-    gsl_interp_accel_reset(_acc);
+  // Compute the slopes of the segments
+  _slope.clear();
+  for (int i = 0; i + 1 < _lnStrain.size(); ++i) {
+    _slope << (_varied.at(i + 1) - _varied.at(i)) /
+                  (_lnStrain.at(i + 1) - _lnStrain.at(i));
   }
 }
 
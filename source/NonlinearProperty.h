@@ -28,8 +28,6 @@
 #include <QList>
 #include <QVector>
 
-#include <gsl/gsl_interp.h>
-
 class SoilType;
 
 //! A class for the shear modulus reduction and damping curves
@@ -61,7 +59,14 @@ public:
   auto name() const -> const QString &;
 
   //! Linear interpolation of the prop for a given strain
-  auto interp(const double strain) -> double;
+  /*!
+   * The interpolation does not modify the property and is safe to call from
+   * multiple threads as long as the curve is not being changed.
+   */
+  auto interp(const double strain) const -> double;
+
+  //! Linear interpolation of the prop for each of the strains
+  void interp(const QVector<double> &strains, QVector<double> &props) const;
 
   //! Create a html document containing the information of the model
   auto toHtml() const -> QString;
@@ -86,9 +91,6 @@ public:
   auto toJson() const -> QJsonObject;
 
 protected:
-  //! Initialize the interpolation routine. Called on the first interpolation
-  void initialize();
-
   //! Name of the model
   QString _name;
 
@@ -101,16 +103,16 @@ protected:
   //! Log of the strain
   QVector<double> _lnStrain;
 
+  //! Slope of the varied property with respect to log strain for each segment
+  QVector<double> _slope;
+
   //! Average value of the property
   QVector<double> _average;
 
   //! Varied value of the property
   QVector<double> _varied;
 
-  //! Accelerator for the interpolation
-  gsl_interp_accel *_acc;
-
-  //! GSL Spline for the interpolation
-  gsl_interp *_interp;
+  //! Index of the segment containing the log strain
+  auto segment(double lnStrain) const -> int;
 };
 #endif // NONLINEAR_PROPERTY_H_
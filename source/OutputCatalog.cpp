@@ -38,6 +38,12 @@
 
 #include <QJsonArray>
 #include <QJsonValue>
+#include <QThreadPool>
+
+namespace {
+//! Depths of the profile outputs while results are extracted on this thread
+thread_local const QVector<double> *extractionDepth = nullptr;
+} // namespace
 
 OutputCatalog::OutputCatalog(QObject *parent)
     : QAbstractTableModel(parent), _selectedOutput(0) {
@@ -52,6 +58,7 @@ OutputCatalog::OutputCatalog(QObject *parent)
   _frequencyIsNeeded = false;
 
   _damping = 5.;
+  _summaryOnly = false;
   _period = new Dimension(this);
   _period->setMin(0.01);
   _period->setMax(10.0);
@@ -254,7 +261,9 @@ auto OutputCatalog::setSelectedOutput(int index) -> AbstractOutput * {
 
 auto OutputCatalog::log() -> TextLog * { return _log; }
 
-auto OutputCatalog::depth() const -> const QVector<double> & { return _depth; }
+auto OutputCatalog::depth() const -> const QVector<double> & {
+  return extractionDepth ? *extractionDepth : _depth;
+}
 
 auto OutputCatalog::time(int motion) const -> const QVector<double> & {
   return _time.at(motion);
@@ -272,6 +281,14 @@ void OutputCatalog::setDamping(double damping) {
   emit wasModified();
 }
 
+auto OutputCatalog::summaryOnly() const -> bool { return _summaryOnly; }
+
+void OutputCatalog::setSummaryOnly(bool summaryOnly) {
+  _summaryOnly = summaryOnly;
+
+  emit wasModified();
+}
+
 auto OutputCatalog::motionCount() const -> int { return _motionCount; }
 
 auto OutputCatalog::siteCount() const -> int { return _siteCount; }
@@ -425,6 +442,8 @@ void OutputCatalog::clear() {
     const auto catalogOutputs = catalog->outputs();
     for (auto *output : catalogOutputs) {
       output->clear();
+      // The retention of the data only changes while the output is empty
+      output->setSummaryOnly(_summaryOnly);
     }
   }
 
@@ -443,20 +462,38 @@ void OutputCatalog::setReadOnly(bool readOnly) {
     catalog->setReadOnly(readOnly);
 }
 
-void OutputCatalog::saveResults(int motion,
-                                AbstractCalculator *const calculator) {
+auto OutputCatalog::prepareResults(double maxDepth) -> QVector<double> {
   // Need to populate the depth vector based on the depth to the last
   // sublayer. These depths are updated as the velocity profile is varied.
-  populateDepthVector(calculator->site()->subLayers().last().depthToBase());
-
-  for (AbstractOutput *output : std::as_const(_outputs)) {
-    output->addData(motion, calculator);
+  populateDepthVector(maxDepth);
+  // The copy is shared until more depths are added
+  return _depth;
+}
+
+auto OutputCatalog::extractResults(int motion,
+                                   AbstractCalculator *const calculator,
+                                   const QVector<double> &depth) const
+    -> QList<QVector<double>> {
+  QList<QVector<double>> results;
+
+  // The outputs use the depths of the realization, which are returned by
+  // depth() on this thread
+  extractionDepth = &depth;
+  for (const AbstractOutput *output : _outputs) {
+    results << output->extractData(motion, calculator);
   }
+  extractionDepth = nullptr;
+
+  return results;
 }
 
-void OutputCatalog::removeLastSite() {
-  for (AbstractOutput *output : std::as_const(_outputs))
-    output->removeLastSite();
+void OutputCatalog::saveResults(int motion,
+                                const QList<QVector<double>> &results) {
+  Q_ASSERT(results.size() == _outputs.size());
+
+  for (int i = 0; i < _outputs.size(); ++i) {
+    _outputs.at(i)->addData(motion, results.at(i));
+  }
 }
 
 auto OutputCatalog::timesAreNeeded() const -> bool { return _timesAreNeeded; }
@@ -499,11 +536,19 @@ auto OutputCatalog::outputs() const -> const QList<AbstractOutput *> & {
 }
 
 void OutputCatalog::exportData(const QString &path, const QString &separator,
-                               const QString &prefix) {
+                               const QString &prefix,
+                               AbstractOutput::ExportFormat format) {
+  // Each output writes its own files, so the outputs are exported at the same
+  // time
+  QThreadPool pool;
   for (AbstractOutput *output : std::as_const(_outputs)) {
-    if (output->exportEnabled())
-      output->exportData(path, separator, prefix);
+    if (output->exportEnabled()) {
+      pool.start([output, &path, &separator, &prefix, format]() {
+        output->exportData(path, separator, prefix, format);
+      });
+    }
   }
+  pool.waitForDone();
 }
 
 void OutputCatalog::populateDepthVector(double maxDepth) {
@@ -549,6 +594,7 @@ void OutputCatalog::fromJson(const QJsonObject &json) {
   _periodIsNeeded = json["periodIsNeeded"].toBool();
   _period->fromJson(json["period"].toObject());
   _damping = json["damping"].toDouble();
+  _summaryOnly = json["summaryOnly"].toBool();
 
   _log->fromJson(json["log"].toObject());
   _profilesOutputCatalog->fromJson(json["profilesOutputCatalog"].toArray());
@@ -584,6 +630,7 @@ auto OutputCatalog::toJson() const -> QJsonObject {
   json["periodIsNeeded"] = _periodIsNeeded;
   json["period"] = _period->toJson();
   json["damping"] = _damping;
+  json["summaryOnly"] = _summaryOnly;
   json["log"] = _log->toJson();
 
   json["profilesOutputCatalog"] = _profilesOutputCatalog->toJson();
@@ -608,14 +655,14 @@ auto OutputCatalog::toJson() const -> QJsonObject {
 }
 
 auto operator<<(QDataStream &out, const OutputCatalog *oc) -> QDataStream & {
-  out << (quint8)1;
+  out << (quint8)2;
 
   out << oc->_title << oc->_filePrefix << oc->_enabled << oc->_frequency
       << oc->_frequencyIsNeeded << oc->_period << oc->_periodIsNeeded
       << oc->_damping << oc->_profilesOutputCatalog << oc->_ratiosOutputCatalog
       << oc->_soilTypesOutputCatalog << oc->_spectraOutputCatalog
       << oc->_timeSeriesOutputCatalog << oc->_log
-      << (oc->_depth.size() ? oc->_depth.last() : -1);
+      << (oc->_depth.size() ? oc->_depth.last() : -1) << oc->_summaryOnly;
 
   return out;
 }
@@ -644,6 +691,9 @@ auto operator>>(QDataStream &in, OutputCatalog *oc) -> QDataStream & {
   in >> oc->_log;
   in >> maxDepth;
 
+  if (ver > 1)
+    in >> oc->_summaryOnly;
+
   if (maxDepth > 0)
     oc->populateDepthVector(maxDepth);
 
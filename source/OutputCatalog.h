@@ -28,10 +28,10 @@
 #include <QStringList>
 #include <QVector>
 
+#include "AbstractOutput.h"
 #include "SoilTypeCatalog.h"
 
 class AbstractCalculator;
-class AbstractOutput;
 class AbstractOutputCatalog;
 class Dimension;
 class MotionLibrary;
@@ -85,6 +85,9 @@ public:
 
   auto damping() const -> double;
 
+  //! If the outputs with statistics only keep a summary of the results
+  auto summaryOnly() const -> bool;
+
   auto motionCount() const -> int;
   auto siteCount() const -> int;
 
@@ -121,22 +124,41 @@ public:
    */
   void finalize();
 
-  /*! Save the results from a calculation
+  /*! Prepare the outputs for the results of a site realization.
+   *
+   * Must be called before extractResults() for the realization.
+   * \param maxDepth depth to the base of the last sublayer
+   * \return the depths of the profile outputs for the realization. Later
+   * realizations may add depths, so the depths are passed to
+   * extractResults().
+   */
+  auto prepareResults(double maxDepth) -> QVector<double>;
+
+  /*! Extract the results from a calculation.
+   *
+   * Does not modify the catalog and may be called from multiple threads,
+   * while the results of later realizations are prepared.
+   * \param depth depths returned by prepareResults() for the realization
+   * \return the data of each of the enabled outputs
    */
-  void saveResults(int motion, AbstractCalculator *const calculator);
+  auto extractResults(int motion, AbstractCalculator *const calculator,
+                      const QVector<double> &depth) const
+      -> QList<QVector<double>>;
 
-  /*! Remove the last site from the output
+  /*! Save the results extracted from a calculation
    */
-  void removeLastSite();
+  void saveResults(int motion, const QList<QVector<double>> &results);
 
   /*! Export the data to files
    *
    * \param path location to save the files
    * \param separator separate the columns of data with this symbol
    * \param prefix prefix to append to the start of filenames
+   * \param format format of the files
    */
   void exportData(const QString &path, const QString &separator = ",",
-                  const QString &prefix = "");
+                  const QString &prefix = "",
+                  AbstractOutput::ExportFormat format = AbstractOutput::Text);
 
   //! Compute the statistics of all of the outputs
   void computeStats();
@@ -156,6 +178,7 @@ public slots:
   void setTitle(const QString &title);
   void setFilePrefix(const QString &prefix);
   void setDamping(double damping);
+  void setSummaryOnly(bool summaryOnly);
 
   //! Clear all saved data
   void clear();
@@ -230,6 +253,9 @@ protected:
   //! Damping of the single-degree-of-freedom system
   double _damping;
 
+  //! If the outputs with statistics only keep a summary of the results
+  bool _summaryOnly;
+
   //! Catalogs of output
   ProfilesOutputCatalog *_profilesOutputCatalog;
   RatiosOutputCatalog *_ratiosOutputCatalog;
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "OutputData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+OutputData::Row::Row(const double *data, int size) : _data(data), _size(size) {}
+
+OutputData::Row::Row(const QVector<double> &vector)
+    : _data(vector.constData()), _size(vector.size()) {}
+
+auto OutputData::Row::toVector() const -> QVector<double> {
+  return QVector<double>(begin(), end());
+}
+
+OutputData::OutputData() : _stride(0) {}
+
+void OutputData::clear() {
+  _stride = 0;
+  _values.clear();
+  _sizes.clear();
+}
+
+void OutputData::reserve(int rowCount, int stride) {
+  if (_stride < stride)
+    restride(stride);
+
+  _values.reserve(rowCount * _stride);
+  _sizes.reserve(rowCount);
+}
+
+void OutputData::append(const QVector<double> &values) {
+  if (_stride < values.size())
+    restride(values.size());
+
+  const qsizetype offset = _values.size();
+  // Rows shorter than the stride are padded with NaN
+  _values.resize(offset + _stride);
+  std::copy(values.constBegin(), values.constEnd(), _values.begin() + offset);
+  std::fill(_values.begin() + offset + values.size(), _values.end(), NAN);
+
+  _sizes << values.size();
+}
+
+void OutputData::truncate(int rowCount) {
+  if (rowCount < _sizes.size()) {
+    _sizes.resize(rowCount);
+    _values.resize(rowCount * _stride);
+  }
+}
+
+auto OutputData::rowCount() const -> int { return _sizes.size(); }
+
+auto OutputData::stride() const -> int { return static_cast<int>(_stride); }
+
+auto OutputData::row(int i) const -> Row {
+  Q_ASSERT(0 <= i && i < _sizes.size());
+  return Row(_values.constData() + i * _stride, _sizes.at(i));
+}
+
+void OutputData::restride(int stride) {
+  // Keep the storage reserved for the rows
+  QVector<double> values;
+  values.reserve(_sizes.capacity() * static_cast<qsizetype>(stride));
+  values.fill(NAN, _sizes.size() * static_cast<qsizetype>(stride));
+
+  for (int i = 0; i < _sizes.size(); ++i) {
+    std::copy_n(_values.constData() + i * _stride, _sizes.at(i),
+                values.begin() + i * static_cast<qsizetype>(stride));
+  }
+
+  _values = std::move(values);
+  _stride = stride;
+}
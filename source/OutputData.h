@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef OUTPUT_DATA_H
+#define OUTPUT_DATA_H
+
+#include <QVector>
+
+/*! Contiguous storage of the data of an output.
+ *
+ * Each trial is stored as a row of a single buffer with a fixed stride, which
+ * is the length of the longest row. Rows are accessed through a lightweight
+ * view that does not copy the data.
+ */
+class OutputData {
+public:
+  //! Read-only view of a row of data
+  class Row {
+  public:
+    Row() = default;
+    Row(const double *data, int size);
+    Row(const QVector<double> &vector);
+
+    auto data() const -> const double * { return _data; }
+    auto size() const -> int { return _size; }
+    auto isEmpty() const -> bool { return _size == 0; }
+
+    auto at(int i) const -> double {
+      Q_ASSERT(0 <= i && i < _size);
+      return _data[i];
+    }
+
+    auto begin() const -> const double * { return _data; }
+    auto end() const -> const double * { return _data + _size; }
+
+    //! Copy of the data
+    auto toVector() const -> QVector<double>;
+
+  private:
+    const double *_data = nullptr;
+    int _size = 0;
+  };
+
+  OutputData();
+
+  //! Remove all rows
+  void clear();
+
+  //! Reserve storage for a number of rows with a given stride
+  void reserve(int rowCount, int stride);
+
+  //! Add a row to the end of the store
+  void append(const QVector<double> &values);
+
+  //! Remove rows from the end of the store
+  void truncate(int rowCount);
+
+  auto rowCount() const -> int;
+
+  //! Length of the longest row
+  auto stride() const -> int;
+
+  auto row(int i) const -> Row;
+
+private:
+  //! Change the stride of the stored rows
+  void restride(int stride);
+
+  //! Number of values between the start of consecutive rows. The offsets
+  //! are computed with qsizetype, as they can exceed the range of an int.
+  qsizetype _stride;
+
+  //! Values of all rows
+  QVector<double> _values;
+
+  //! Length of each row
+  QVector<int> _sizes;
+};
+
+#endif // OUTPUT_DATA_H
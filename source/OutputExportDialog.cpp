@@ -83,12 +83,16 @@ void OutputExportDialog::exportData() {
     _model->outputs().at(i)->setExportEnabled(
         _tableWidget->item(i, 0)->checkState());
 
-  // Output to CSV
-  _model->exportData(destDir.path(), ",", _prefixLineEdit->text());
+  // Output to the selected format
+  _model->exportData(
+      destDir.path(), ",", _prefixLineEdit->text(),
+      (AbstractOutput::ExportFormat)_formatComboBox->currentIndex());
 
-  // Save the path
+  // Save the path and format
   QSettings settings;
   settings.setValue("outputExportDialog/path", destDir.absolutePath());
+  settings.setValue("outputExportDialog/format",
+                    _formatComboBox->currentIndex());
 
   accept();
 }
@@ -121,6 +125,15 @@ void OutputExportDialog::createDialog() {
   layout->addWidget(new QLabel("Prefix:"), 1, 0);
   layout->addWidget(_prefixLineEdit, 1, 1);
 
+  // Format, in the order of AbstractOutput::ExportFormat
+  _formatComboBox = new QComboBox;
+  _formatComboBox->addItems(QStringList() << tr("Comma separated (*.csv)")
+                                          << tr("NumPy array (*.npy)"));
+  _formatComboBox->setCurrentIndex(
+      settings.value("outputExportDialog/format", 0).toInt());
+  layout->addWidget(new QLabel(tr("Format:")), 2, 0);
+  layout->addWidget(_formatComboBox, 2, 1);
+
   // View of possible output
   _tableWidget = new QTableWidget(_model->outputs().size(), 1, this);
   _tableWidget->setHorizontalHeaderLabels(QStringList() << tr("Output Name"));
@@ -140,7 +153,7 @@ void OutputExportDialog::createDialog() {
   _tableWidget->resizeColumnsToContents();
   _tableWidget->resizeRowsToContents();
 
-  layout->addWidget(_tableWidget, 2, 0, 1, 2);
+  layout->addWidget(_tableWidget, 3, 0, 1, 2);
 
   // Button box
   auto *buttonBox = new QDialogButtonBox(
@@ -151,7 +164,7 @@ void OutputExportDialog::createDialog() {
   connect(buttonBox, &QDialogButtonBox::rejected, this,
           &OutputExportDialog::reject);
 
-  layout->addWidget(buttonBox, 3, 0, 1, 2);
+  layout->addWidget(buttonBox, 4, 0, 1, 2);
 
   // Set the layout
   setLayout(layout);
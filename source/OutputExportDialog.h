@@ -24,6 +24,7 @@
 
 #include <QDialog>
 
+#include <QComboBox>
 #include <QLineEdit>
 #include <QTableWidget>
 
@@ -54,6 +55,9 @@ private:
   //! Selected fileName prefix
   QLineEdit *_prefixLineEdit;
 
+  //! Selected file format
+  QComboBox *_formatComboBox;
+
   //! Create the page
   void createDialog();
 };
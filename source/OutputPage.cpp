@@ -37,6 +37,7 @@
 #include <QDebug>
 #include <QFormLayout>
 #include <QGridLayout>
+#include <QVBoxLayout>
 
 OutputPage::OutputPage(QWidget *parent, Qt::WindowFlags f)
     : AbstractPage(parent, f) {
@@ -47,7 +48,7 @@ OutputPage::OutputPage(QWidget *parent, Qt::WindowFlags f)
   _soilTypesTableView = new QTableView;
 
   auto *layout = new QGridLayout;
-  layout->setRowStretch(3, 1);
+  layout->setRowStretch(4, 1);
 
   // Tab widget
   // Left Column
@@ -59,11 +60,12 @@ OutputPage::OutputPage(QWidget *parent, Qt::WindowFlags f)
   _tabWidget->addTab(_ratiosTableFrame, tr("Ratios"));
   _tabWidget->addTab(_soilTypesTableView, tr("Soil Types"));
 
-  layout->addWidget(_tabWidget, 0, 0, 4, 1);
+  layout->addWidget(_tabWidget, 0, 0, 5, 1);
   layout->addWidget(createRespSpecGroupBox(), 0, 1);
 
   layout->addWidget(createFreqGroupBox(), 1, 1);
   layout->addWidget(createLogGroupBox(), 2, 1);
+  layout->addWidget(createStorageGroupBox(), 3, 1);
 
   // Set general layout
   setLayout(layout);
@@ -101,6 +103,10 @@ void OutputPage::setModel(SiteResponseModel *model) {
   connect(_logLevelComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
           oc->log(), qOverload<int>(&TextLog::setLevel));
 
+  _summaryOnlyCheckBox->setChecked(oc->summaryOnly());
+  connect(_summaryOnlyCheckBox, &QCheckBox::toggled, oc,
+          &OutputCatalog::setSummaryOnly);
+
   setApproach(model->motionLibrary()->approach());
   connect(model->motionLibrary(), &MotionLibrary::approachChanged, this,
           &OutputPage::setApproach);
@@ -117,6 +123,7 @@ void OutputPage::setReadOnly(bool readOnly) {
   _frequencyLayout->setReadOnly(readOnly);
 
   _logLevelComboBox->setDisabled(readOnly);
+  _summaryOnlyCheckBox->setDisabled(readOnly);
 }
 
 void OutputPage::setApproach(int approach) {
@@ -175,3 +182,20 @@ auto OutputPage::createLogGroupBox() -> QGroupBox * {
 
   return _logGroupBox;
 }
+
+auto OutputPage::createStorageGroupBox() -> QGroupBox * {
+  auto *layout = new QVBoxLayout;
+
+  _summaryOnlyCheckBox =
+      new QCheckBox(tr("Only keep the statistics of the results"));
+  _summaryOnlyCheckBox->setToolTip(
+      tr("Outputs with statistics keep the median, standard deviation, and "
+         "percentiles instead of the results of every realization."));
+
+  layout->addWidget(_summaryOnlyCheckBox);
+
+  _storageGroupBox = new QGroupBox(tr("Storage Properties"));
+  _storageGroupBox->setLayout(layout);
+
+  return _storageGroupBox;
+}
@@ -24,6 +24,7 @@
 
 #include "AbstractPage.h"
 
+#include <QCheckBox>
 #include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QFrame>
@@ -73,6 +74,9 @@ private:
   QGroupBox *_logGroupBox;
   QComboBox *_logLevelComboBox;
 
+  QGroupBox *_storageGroupBox;
+  QCheckBox *_summaryOnlyCheckBox;
+
   //! Create the response spectrum group box
   auto createRespSpecGroupBox() -> QGroupBox *;
 
@@ -82,6 +86,9 @@ private:
   //! Create the output group box
   auto createLogGroupBox() -> QGroupBox *;
 
+  //! Create the data storage group box
+  auto createStorageGroupBox() -> QGroupBox *;
+
   SiteResponseModel *_model;
 };
 #endif
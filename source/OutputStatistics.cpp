@@ -24,57 +24,90 @@
 #include "AbstractOutput.h"
 
 #include <QDebug>
+#include <QJsonArray>
 #include <QPen>
 
+#include <algorithm>
 #include <cmath>
 
 OutputStatistics::OutputStatistics(AbstractOutput *output)
     : QObject(output), _output(output), _distribution(LogNormal) {
   connect(_output, &AbstractOutput::cleared, this, &OutputStatistics::clear);
+
+  _fractiles << QuantileSketch(0.16) << QuantileSketch(0.50)
+             << QuantileSketch(0.84);
+}
+
+void OutputStatistics::add(const OutputData::Row &row) {
+  _normalStats.add(row.data(), row.size());
+  _logStats.add(row.data(), row.size(), true);
+
+  if (_output->summaryOnly()) {
+    for (QuantileSketch &qs : _fractiles)
+      qs.add(row.data(), row.size());
+  }
+
+  // The curves are only computed from the accumulators by calculate(), once
+  // the output is finalized
 }
 
 void OutputStatistics::calculate() {
   if (!hasEnoughData())
     return;
 
-  // Resize everything to the appropriate size
-  _average.clear();
-  _stdev.clear();
+  // A summary has no data to recompute the statistics from, so they always
+  // include all of the series.
+  if (_output->summaryOnly()) {
+    update();
+    return;
+  }
+
+  // The running statistics are used if they include all of the series.
+  // Otherwise, for example after a series is disabled or the results are
+  // loaded, they are computed from the stored data.
+  bool isCurrent = _normalStats.vectorCount() ==
+                   _output->siteCount() * _output->motionCount();
+  for (int s = 0; isCurrent && s < _output->siteCount(); ++s) {
+    for (int m = 0; isCurrent && m < _output->motionCount(); ++m) {
+      isCurrent = _output->seriesEnabled(s, m);
+    }
+  }
 
-  for (int i = 0; i < _output->ref().size(); ++i) {
-    int count = 0;
-    double sum = 0;
-    double sqrSum = 0;
+  if (!isCurrent) {
+    _normalStats.clear();
+    _logStats.clear();
 
-    // Add up all of the known data
     for (int s = 0; s < _output->siteCount(); ++s) {
       for (int m = 0; m < _output->motionCount(); ++m) {
-        if (_output->seriesEnabled(s, m) && i < _output->data(s, m).size()) {
-          double dataPt = _output->data(s, m).at(i);
-
-          if (_distribution == LogNormal)
-            dataPt = log(dataPt);
-
-          sum += dataPt;
-          sqrSum += dataPt * dataPt;
-          ++count;
+        if (_output->seriesEnabled(s, m)) {
+          const OutputData::Row row = _output->data(s, m);
+          _normalStats.add(row.data(), row.size());
+          _logStats.add(row.data(), row.size(), true);
         }
       }
     }
+  }
+
+  update();
+}
+
+void OutputStatistics::update() {
+  const RunningStatistics &stats =
+      (_distribution == LogNormal) ? _logStats : _normalStats;
 
-    if (count) {
-      _average << (sum / count);
+  // Resize everything to the appropriate size
+  _average.clear();
+  _stdev.clear();
 
-      // Compute the standard deviation. The absolute value is used to deal
-      // with rounding errors. At times the difference with go negative when
-      // all of the values are the same number.
-      _stdev << ((count > 2)
-                     ? sqrt(abs(sqrSum - (sum * sum) / count) / (count - 1))
-                     : 0);
-    } else {
+  const int n = std::min(int(_output->ref().size()), stats.size());
+  for (int i = 0; i < n; ++i) {
+    if (!stats.count(i)) {
       // No more data stop
       break;
     }
+
+    _average << stats.mean(i);
+    _stdev << stats.stdev(i);
   }
 
   if (_distribution == LogNormal) {
@@ -128,6 +161,10 @@ auto OutputStatistics::hasEnoughData() const -> bool {
          ((_output->motionCount() * _output->siteCount()) > 1);
 }
 
+auto OutputStatistics::count() const -> int {
+  return _normalStats.vectorCount();
+}
+
 auto OutputStatistics::distribution() const -> OutputStatistics::Distribution {
   return _distribution;
 }
@@ -175,7 +212,46 @@ auto OutputStatistics::stdev() const -> const QVector<double> & {
   return _stdev;
 }
 
+auto OutputStatistics::fractileCount() const -> int {
+  return _fractiles.size();
+}
+
+auto OutputStatistics::fractileLabel(int fractile) const -> QString {
+  return tr("%1th Percentile")
+      .arg(qRound(100 * _fractiles.at(fractile).probability()));
+}
+
+auto OutputStatistics::fractile(int fractile, int i) const -> double {
+  return _fractiles.at(fractile).quantile(i);
+}
+
+void OutputStatistics::fromJson(const QJsonObject &json) {
+  _normalStats.fromJson(json["normal"].toObject());
+  _logStats.fromJson(json["log"].toObject());
+
+  const QJsonArray fractiles = json["fractiles"].toArray();
+  for (int i = 0; i < fractiles.size() && i < _fractiles.size(); ++i)
+    _fractiles[i].fromJson(fractiles.at(i).toObject());
+}
+
+auto OutputStatistics::toJson() const -> QJsonObject {
+  QJsonObject json;
+  json["normal"] = _normalStats.toJson();
+  json["log"] = _logStats.toJson();
+
+  QJsonArray fractiles;
+  for (const QuantileSketch &qs : _fractiles)
+    fractiles << qs.toJson();
+  json["fractiles"] = fractiles;
+
+  return json;
+}
+
 void OutputStatistics::clear() {
+  _normalStats.clear();
+  _logStats.clear();
+  for (QuantileSketch &qs : _fractiles)
+    qs.clear();
   _average.clear();
   _stdev.clear();
   _plusStd.clear();
@@ -205,3 +281,21 @@ auto OutputStatistics::plotCurve(QwtPlot *const plot,
 
   return qpc;
 }
+
+auto operator<<(QDataStream &out, const OutputStatistics *os)
+    -> QDataStream & {
+  out << (quint8)1;
+
+  out << os->_normalStats << os->_logStats << os->_fractiles;
+
+  return out;
+}
+
+auto operator>>(QDataStream &in, OutputStatistics *os) -> QDataStream & {
+  quint8 ver;
+  in >> ver;
+
+  in >> os->_normalStats >> os->_logStats >> os->_fractiles;
+
+  return in;
+}
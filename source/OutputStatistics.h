@@ -22,6 +22,12 @@
 #ifndef OUTPUTSTATISTICS_H
 #define OUTPUTSTATISTICS_H
 
+#include "OutputData.h"
+#include "QuantileSketch.h"
+#include "RunningStatistics.h"
+
+#include <QDataStream>
+#include <QJsonObject>
 #include <QObject>
 
 #include <qwt_plot.h>
@@ -32,6 +38,11 @@ class AbstractOutput;
 class OutputStatistics : public QObject {
   Q_OBJECT
 
+  friend auto operator<<(QDataStream &out, const OutputStatistics *os)
+      -> QDataStream &;
+  friend auto operator>>(QDataStream &in, OutputStatistics *os)
+      -> QDataStream &;
+
 public:
   explicit OutputStatistics(AbstractOutput *output);
 
@@ -40,12 +51,19 @@ public:
     LogNormal //!< Log Normal Distribution (average=median, stdev=lnStd)
   };
 
+  //! Add a series to the running statistics, without updating the curves
+  void add(const OutputData::Row &row);
+
+  //! Compute the statistics of the enabled series
   void calculate();
   void plot(QwtPlot *qwtPlot) const;
 
   //! If the output has enough data to compute statistics
   auto hasEnoughData() const -> bool;
 
+  //! Number of series added to the running statistics
+  auto count() const -> int;
+
   auto distribution() const -> Distribution;
   void setDistribution(Distribution distribution);
 
@@ -55,6 +73,21 @@ public:
   auto average() const -> const QVector<double> &;
   auto stdev() const -> const QVector<double> &;
 
+  /*! Number of fractiles estimated by the quantile sketches.
+   *
+   * The sketches are only updated for outputs that keep a summary of the
+   * results, see AbstractOutput::summaryOnly().
+   */
+  auto fractileCount() const -> int;
+  auto fractileLabel(int fractile) const -> QString;
+
+  //! Estimate of a fractile at a point
+  auto fractile(int fractile, int i) const -> double;
+
+  //! Save the running statistics, which replace the data of a summary
+  void fromJson(const QJsonObject &json);
+  auto toJson() const -> QJsonObject;
+
 public slots:
   void setDistribution(int distribution);
 
@@ -66,6 +99,9 @@ protected slots:
   void clear();
 
 protected:
+  //! Compute the statistics from the running statistics
+  void update();
+
   auto plotCurve(QwtPlot *const plot, const QVector<double> &data,
                  Qt::PenStyle penStyle) const -> QwtPlotCurve *;
 
@@ -75,6 +111,13 @@ protected:
   //! Assumed distribution
   Distribution _distribution;
 
+  //! Running statistics of the values and of the log of the values
+  RunningStatistics _normalStats;
+  RunningStatistics _logStats;
+
+  //! Sketches of the 16th, 50th, and 84th percentiles
+  QList<QuantileSketch> _fractiles;
+
   //! Average value
   QVector<double> _average;
 
@@ -88,4 +131,8 @@ protected:
   QVector<double> _minusStd;
 };
 
+auto operator<<(QDataStream &out, const OutputStatistics *os)
+    -> QDataStream &;
+auto operator>>(QDataStream &in, OutputStatistics *os) -> QDataStream &;
+
 #endif // OUTPUTSTATISTICS_H
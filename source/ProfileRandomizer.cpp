@@ -24,6 +24,7 @@
 #include "BedrockDepthVariation.h"
 #include "Distribution.h"
 #include "LayerThicknessVariation.h"
+#include "MyRandomNumGenerator.h"
 #include "RockLayer.h"
 #include "SoilLayer.h"
 #include "SoilProfile.h"
@@ -39,20 +40,25 @@
 #include <algorithm>
 #include <cmath>
 
-ProfileRandomizer::ProfileRandomizer(gsl_rng *rng, SoilProfile *siteProfile)
+ProfileRandomizer::ProfileRandomizer(MyRandomNumGenerator *randNumGen,
+                                     SoilProfile *siteProfile)
     : _siteProfile(siteProfile) {
   connect(_siteProfile, &SoilProfile::isVariedChanged, this,
           &ProfileRandomizer::updateEnabled);
 
-  _bedrockDepthVariation = new BedrockDepthVariation(rng, this);
+  _bedrockDepthVariation = new BedrockDepthVariation(
+      randNumGen->gsl_pointer(MyRandomNumGenerator::BedrockDepthStream), this);
   connect(_bedrockDepthVariation, &BedrockDepthVariation::wasModified, this,
           &ProfileRandomizer::wasModified);
 
-  _layerThicknessVariation = new LayerThicknessVariation(rng, this);
+  _layerThicknessVariation = new LayerThicknessVariation(
+      randNumGen->gsl_pointer(MyRandomNumGenerator::LayerThicknessStream),
+      this);
   connect(_layerThicknessVariation, &LayerThicknessVariation::wasModified, this,
           &ProfileRandomizer::wasModified);
 
-  _velocityVariation = new VelocityVariation(rng, this);
+  _velocityVariation = new VelocityVariation(
+      randNumGen->gsl_pointer(MyRandomNumGenerator::VelocityStream), this);
   connect(_velocityVariation, &VelocityVariation::wasModified, this,
           &ProfileRandomizer::wasModified);
 
@@ -32,10 +32,9 @@
 #include <QTextStream>
 #include <QVariant>
 
-#include <gsl/gsl_rng.h>
-
 class BedrockDepthVariation;
 class LayerThicknessVariation;
+class MyRandomNumGenerator;
 class RockLayer;
 class SoilProfile;
 class SoilLayer;
@@ -55,7 +54,7 @@ class ProfileRandomizer : public QObject {
       -> QDataStream &;
 
 public:
-  ProfileRandomizer(gsl_rng *rng, SoilProfile *siteProfile);
+  ProfileRandomizer(MyRandomNumGenerator *randNumGen, SoilProfile *siteProfile);
   ~ProfileRandomizer();
 
   auto enabled() const -> bool;
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantileSketch.h"
+
+#include "Serialize.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QuantileSketch::QuantileSketch(double probability)
+    : _probability(probability) {
+  _increments[0] = 0;
+  _increments[1] = probability / 2;
+  _increments[2] = probability;
+  _increments[3] = (1 + probability) / 2;
+  _increments[4] = 1;
+}
+
+void QuantileSketch::clear() {
+  _counts.clear();
+  _heights.clear();
+  _positions.clear();
+  _desired.clear();
+}
+
+void QuantileSketch::add(const double *values, int size) {
+  if (_counts.size() < size) {
+    _counts.resize(size);
+    _heights.resize(markerCount * size);
+    _positions.resize(markerCount * size);
+    _desired.resize(markerCount * size);
+  }
+
+  for (int i = 0; i < size; ++i)
+    add(i, values[i]);
+}
+
+void QuantileSketch::add(int i, double value) {
+  double *q = _heights.data() + markerCount * i;
+  double *n = _positions.data() + markerCount * i;
+  double *np = _desired.data() + markerCount * i;
+  const int count = _counts[i]++;
+
+  if (count < markerCount) {
+    // Collect the initial values, which become the markers
+    q[count] = value;
+
+    if (count + 1 == markerCount) {
+      std::sort(q, q + markerCount);
+      for (int j = 0; j < markerCount; ++j) {
+        n[j] = j;
+        np[j] = 4 * _increments[j];
+      }
+    }
+    return;
+  }
+
+  // Find the cell containing the value, extending the extreme markers
+  int k;
+  if (value < q[0]) {
+    q[0] = value;
+    k = 0;
+  } else if (value >= q[4]) {
+    q[4] = value;
+    k = 3;
+  } else {
+    k = 0;
+    while (value >= q[k + 1])
+      ++k;
+  }
+
+  for (int j = k + 1; j < markerCount; ++j)
+    n[j] += 1;
+
+  for (int j = 0; j < markerCount; ++j)
+    np[j] += _increments[j];
+
+  // Move the middle markers toward their desired positions
+  for (int j = 1; j < markerCount - 1; ++j) {
+    const double d = np[j] - n[j];
+
+    if ((d >= 1 && n[j + 1] - n[j] > 1) || (d <= -1 && n[j - 1] - n[j] < -1)) {
+      const int s = (d > 0) ? 1 : -1;
+
+      // Piecewise parabolic prediction of the height
+      const double qp =
+          q[j] + s / (n[j + 1] - n[j - 1]) *
+                     ((n[j] - n[j - 1] + s) * (q[j + 1] - q[j]) /
+                          (n[j + 1] - n[j]) +
+                      (n[j + 1] - n[j] - s) * (q[j] - q[j - 1]) /
+                          (n[j] - n[j - 1]));
+
+      if (q[j - 1] < qp && qp < q[j + 1]) {
+        q[j] = qp;
+      } else {
+        // Linear prediction keeps the markers in order
+        q[j] += s * (q[j + s] - q[j]) / (n[j + s] - n[j]);
+      }
+      n[j] += s;
+    }
+  }
+}
+
+auto QuantileSketch::probability() const -> double { return _probability; }
+
+auto QuantileSketch::size() const -> int { return _counts.size(); }
+
+auto QuantileSketch::count(int i) const -> int { return _counts.at(i); }
+
+auto QuantileSketch::quantile(int i) const -> double {
+  const int count = _counts.at(i);
+  const double *q = _heights.constData() + markerCount * i;
+
+  if (count >= markerCount)
+    return q[2];
+
+  if (count == 0)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  // Interpolate between the sorted values
+  double sorted[markerCount];
+  std::copy(q, q + count, sorted);
+  std::sort(sorted, sorted + count);
+
+  const double pos = _probability * (count - 1);
+  const int lower = std::min(int(pos), count - 1);
+  const int upper = std::min(lower + 1, count - 1);
+  return sorted[lower] + (pos - lower) * (sorted[upper] - sorted[lower]);
+}
+
+void QuantileSketch::fromJson(const QJsonObject &json) {
+  *this = QuantileSketch(json["probability"].toDouble());
+
+  const QJsonArray counts = json["counts"].toArray();
+  for (const QJsonValue &qjv : counts)
+    _counts << qjv.toInt();
+
+  Serialize::toDoubleVector(json["heights"], _heights);
+  Serialize::toDoubleVector(json["positions"], _positions);
+  Serialize::toDoubleVector(json["desired"], _desired);
+}
+
+auto QuantileSketch::toJson() const -> QJsonObject {
+  QJsonObject json;
+  json["probability"] = _probability;
+
+  QJsonArray counts;
+  for (int count : _counts)
+    counts << count;
+  json["counts"] = counts;
+
+  json["heights"] = Serialize::toJsonArray(_heights);
+  json["positions"] = Serialize::toJsonArray(_positions);
+  json["desired"] = Serialize::toJsonArray(_desired);
+  return json;
+}
+
+auto operator<<(QDataStream &out, const QuantileSketch &qs) -> QDataStream & {
+  out << (quint8)1;
+
+  out << qs._probability << qs._counts << qs._heights << qs._positions
+      << qs._desired;
+
+  return out;
+}
+
+auto operator>>(QDataStream &in, QuantileSketch &qs) -> QDataStream & {
+  quint8 ver;
+  in >> ver;
+
+  double probability;
+  in >> probability;
+
+  qs = QuantileSketch(probability);
+  in >> qs._counts >> qs._heights >> qs._positions >> qs._desired;
+
+  return in;
+}
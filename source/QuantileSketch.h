@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <QDataStream>
+#include <QJsonObject>
+#include <QVector>
+
+/*! Streaming estimate of a quantile of a series of vectors.
+ *
+ * Each point of the vectors is estimated with the P-squared algorithm of Jain
+ * and Chlamtac (1985), which tracks five markers instead of storing the
+ * values. The memory is independent of the number of vectors added. Until
+ * five values are known, the quantile is interpolated from the values.
+ */
+class QuantileSketch {
+  friend auto operator<<(QDataStream &out, const QuantileSketch &qs)
+      -> QDataStream &;
+  friend auto operator>>(QDataStream &in, QuantileSketch &qs)
+      -> QDataStream &;
+
+public:
+  explicit QuantileSketch(double probability = 0.5);
+
+  //! Remove all values
+  void clear();
+
+  //! Add the values of a vector
+  void add(const double *values, int size);
+
+  //! Probability of the quantile
+  auto probability() const -> double;
+
+  //! Number of points with at least one value
+  auto size() const -> int;
+
+  //! Number of values at a point
+  auto count(int i) const -> int;
+
+  //! Estimate of the quantile at a point
+  auto quantile(int i) const -> double;
+
+  void fromJson(const QJsonObject &json);
+  auto toJson() const -> QJsonObject;
+
+  //! Number of markers used for each point
+  static const int markerCount = 5;
+
+private:
+  //! Add a value to the markers of a point
+  void add(int i, double value);
+
+  double _probability;
+
+  //! Increments of the desired marker positions
+  double _increments[markerCount];
+
+  QVector<int> _counts;
+
+  //! Marker heights, positions, and desired positions of each point
+  QVector<double> _heights;
+  QVector<double> _positions;
+  QVector<double> _desired;
+};
+
+auto operator<<(QDataStream &out, const QuantileSketch &qs) -> QDataStream &;
+auto operator>>(QDataStream &in, QuantileSketch &qs) -> QDataStream &;
+
+#endif // QUANTILE_SKETCH_H
@@ -151,13 +151,17 @@ void ResultsPage::setSelectedSeries(const QModelIndex &current,
                                     const QModelIndex &previous) {
   Q_UNUSED(previous);
 
+  Q_ASSERT(_selectedOutput);
+  // A summary has no series to select
+  if (_selectedOutput->summaryOnly())
+    return;
+
   if (_selectedRow >= 0)
     // Set the old record to gray
     uncolorCurve(_selectedRow);
 
   _selectedRow = current.row();
 
-  Q_ASSERT(_selectedOutput);
   _selectedOutput->setMotionIndex(_selectedOutput->intToMotion(_selectedRow));
 
   // Colorized newly selected row
@@ -193,6 +197,10 @@ void ResultsPage::selectedDataChanged(const QModelIndex &current,
                                       const QModelIndex &previous) {
   Q_UNUSED(previous);
 
+  // The columns of a summary are the statistics rather than the series
+  if (_selectedOutput->summaryOnly())
+    return;
+
   int row = current.column() - 1;
 
   if (row >= 0) {
@@ -242,15 +250,23 @@ void ResultsPage::setSelectedOutput(int index) {
           &QItemSelectionModel::currentColumnChanged, this,
           &ResultsPage::selectedDataChanged);
 
+  // Only the statistics of a summary are available, so the series can't be
+  // selected, enabled, or disabled
+  const bool summaryOnly = _selectedOutput->summaryOnly();
+  _catalogTableView->setHidden(summaryOnly);
+  _recomputePushButton->setHidden(summaryOnly);
+
   // Site indepedent
   _catalogTableView->setColumnHidden(OutputCatalog::SiteColumn,
                                      _selectedOutput->siteIndependent());
-  _enableSitePushButton->setHidden(_selectedOutput->siteIndependent());
+  _enableSitePushButton->setHidden(_selectedOutput->siteIndependent() ||
+                                   summaryOnly);
 
   // Motion independent
   _catalogTableView->setColumnHidden(OutputCatalog::MotionColumn,
                                      _selectedOutput->motionIndependent());
-  _enableMotionPushButton->setHidden(_selectedOutput->motionIndependent());
+  _enableMotionPushButton->setHidden(_selectedOutput->motionIndependent() ||
+                                     summaryOnly);
 
   if (_selectedOutput && _selectedRow >= 0)
     setSelectedSeries(_outputCatalog->index(_selectedRow, 0));
@@ -262,6 +278,9 @@ void ResultsPage::pointSelected(const QPoint &point) {
   double minDistance = -1;
   int minIndex = 0;
 
+  if (_curves.isEmpty())
+    return;
+
   for (int i = 0; i < _curves.size(); ++i) {
     _curves.at(i)->closestPoint(point, &distance);
 
@@ -282,7 +301,8 @@ void ResultsPage::enableSelectedCurve(int index) {
 }
 
 void ResultsPage::colorCurve(int row) {
-  if (!_selectedOutput || _selectedRow < 0)
+  if (!_selectedOutput || _selectedRow < 0 || row < 0 ||
+      row >= _curves.size())
     return;
 
   QPen pen = _outputCatalog->enabledAt(row) ? QPen(QBrush(Qt::darkGreen), 2)
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RunningStatistics.h"
+
+#include "Serialize.h"
+
+#include <QJsonArray>
+
+#include <cmath>
+
+RunningStatistics::RunningStatistics() : _vectorCount(0) {}
+
+void RunningStatistics::clear() {
+  _vectorCount = 0;
+  _counts.clear();
+  _means.clear();
+  _m2.clear();
+}
+
+void RunningStatistics::add(const double *values, int size, bool logValues) {
+  if (_counts.size() < size) {
+    _counts.resize(size);
+    _means.resize(size);
+    _m2.resize(size);
+  }
+
+  int *counts = _counts.data();
+  double *means = _means.data();
+  double *m2 = _m2.data();
+  for (int i = 0; i < size; ++i) {
+    const double value = logValues ? log(values[i]) : values[i];
+
+    const int count = ++counts[i];
+    const double delta = value - means[i];
+    means[i] += delta / count;
+    m2[i] += delta * (value - means[i]);
+  }
+
+  ++_vectorCount;
+}
+
+auto RunningStatistics::vectorCount() const -> int { return _vectorCount; }
+
+auto RunningStatistics::size() const -> int { return _counts.size(); }
+
+auto RunningStatistics::count(int i) const -> int { return _counts.at(i); }
+
+auto RunningStatistics::mean(int i) const -> double { return _means.at(i); }
+
+auto RunningStatistics::stdev(int i) const -> double {
+  const int count = _counts.at(i);
+  return (count > 2) ? sqrt(std::abs(_m2.at(i)) / (count - 1)) : 0;
+}
+
+void RunningStatistics::fromJson(const QJsonObject &json) {
+  clear();
+  _vectorCount = json["vectorCount"].toInt();
+
+  const QJsonArray counts = json["counts"].toArray();
+  for (const QJsonValue &qjv : counts)
+    _counts << qjv.toInt();
+
+  Serialize::toDoubleVector(json["means"], _means);
+  Serialize::toDoubleVector(json["m2"], _m2);
+}
+
+auto RunningStatistics::toJson() const -> QJsonObject {
+  QJsonObject json;
+  json["vectorCount"] = _vectorCount;
+
+  QJsonArray counts;
+  for (int count : _counts)
+    counts << count;
+  json["counts"] = counts;
+
+  json["means"] = Serialize::toJsonArray(_means);
+  json["m2"] = Serialize::toJsonArray(_m2);
+  return json;
+}
+
+auto operator<<(QDataStream &out, const RunningStatistics &rs)
+    -> QDataStream & {
+  out << (quint8)1;
+
+  out << (qint32)rs._vectorCount << rs._counts << rs._means << rs._m2;
+
+  return out;
+}
+
+auto operator>>(QDataStream &in, RunningStatistics &rs) -> QDataStream & {
+  quint8 ver;
+  in >> ver;
+
+  qint32 vectorCount;
+  in >> vectorCount >> rs._counts >> rs._means >> rs._m2;
+  rs._vectorCount = vectorCount;
+
+  return in;
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RUNNING_STATISTICS_H
+#define RUNNING_STATISTICS_H
+
+#include <QDataStream>
+#include <QJsonObject>
+#include <QVector>
+
+/*! Online mean and variance of a series of vectors.
+ *
+ * Each point of the vectors is updated with Welford's algorithm, which avoids
+ * the cancellation of the sum of squares formulation. Vectors may have
+ * different lengths, in which case the later points have fewer values.
+ */
+class RunningStatistics {
+  friend auto operator<<(QDataStream &out, const RunningStatistics &rs)
+      -> QDataStream &;
+  friend auto operator>>(QDataStream &in, RunningStatistics &rs)
+      -> QDataStream &;
+
+public:
+  RunningStatistics();
+
+  //! Remove all values
+  void clear();
+
+  /*! Add the values of a vector
+   *
+   * \param values pointer to the values
+   * \param size number of values
+   * \param logValues if the natural log of the values is used
+   */
+  void add(const double *values, int size, bool logValues = false);
+
+  //! Number of vectors added
+  auto vectorCount() const -> int;
+
+  //! Number of points with at least one value
+  auto size() const -> int;
+
+  //! Number of values at a point
+  auto count(int i) const -> int;
+
+  //! Mean of the values at a point
+  auto mean(int i) const -> double;
+
+  //! Sample standard deviation at a point, zero for fewer than three values
+  auto stdev(int i) const -> double;
+
+  void fromJson(const QJsonObject &json);
+  auto toJson() const -> QJsonObject;
+
+private:
+  int _vectorCount;
+
+  QVector<int> _counts;
+  QVector<double> _means;
+
+  //! Sum of the squared differences from the mean
+  QVector<double> _m2;
+};
+
+auto operator<<(QDataStream &out, const RunningStatistics &rs)
+    -> QDataStream &;
+auto operator>>(QDataStream &in, RunningStatistics &rs) -> QDataStream &;
+
+#endif // RUNNING_STATISTICS_H
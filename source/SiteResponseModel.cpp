@@ -34,6 +34,7 @@
 #include "ProfilesOutputCatalog.h"
 #include "SoilProfile.h"
 #include "SoilTypesOutputCatalog.h"
+#include "SubLayer.h"
 #include "TextLog.h"
 #include "Units.h"
 
@@ -41,12 +42,17 @@
 #include <QFile>
 #include <QJsonDocument>
 #include <QMetaProperty>
+#include <QMutexLocker>
 #include <QProgressBar>
 #include <QTextDocument>
+#include <QThreadPool>
 #include <QTimer>
+#include <QWaitCondition>
 
 #include <QDebug>
 
+#include <algorithm>
+
 SiteResponseModel::SiteResponseModel(QObject *parent)
     : QThread(parent), _calculator(nullptr) {
   _modified = false;
@@ -54,6 +60,7 @@ SiteResponseModel::SiteResponseModel(QObject *parent)
   _method = EquivalentLinear;
   _okToContinue = true;
   _isLoaded = false;
+  _threadCount = 0;
 
   connect(Units::instance(), &Units::systemChanged, this,
           [this]() { setModified(); });
@@ -154,6 +161,17 @@ void SiteResponseModel::setMethod(int method) {
   setMethod(static_cast<Method>(method));
 }
 
+auto SiteResponseModel::threadCount() const -> int { return _threadCount; }
+
+void SiteResponseModel::setThreadCount(int threadCount) {
+  if (_threadCount != threadCount) {
+    _threadCount = threadCount;
+
+    emit threadCountChanged(_threadCount);
+    setModified(true);
+  }
+}
+
 auto SiteResponseModel::dampingRequired() const -> bool {
   return _method == LinearElastic;
 }
@@ -182,6 +200,10 @@ auto SiteResponseModel::notes() const -> QTextDocument * { return _notes; }
 void SiteResponseModel::stop() {
   _okToContinue = false;
   _calculator->stop();
+
+  QMutexLocker locker(&_activeCalculatorsMutex);
+  for (AbstractCalculator *calculator : std::as_const(_activeCalculators))
+    calculator->stop();
 }
 
 void SiteResponseModel::clearResults() {
@@ -307,6 +329,7 @@ auto SiteResponseModel::loadJson(const QString &fileName) -> bool {
   //
   _notes->setHtml(json["notes"].toString());
   Units::instance()->setSystem(json["system"].toInt());
+  setThreadCount(json["threadCount"].toInt(0));
 
   _randNumGen->fromJson(json["randNumGen"].toObject());
   _siteProfile->fromJson(json["siteProfile"].toObject());
@@ -368,6 +391,7 @@ auto SiteResponseModel::saveJson() -> bool {
   json["method"] = static_cast<int>(_method);
   json["hasResults"] = _hasResults;
   json["system"] = static_cast<int>(Units::instance()->system());
+  json["threadCount"] = _threadCount;
 
   json["randNumGen"] = _randNumGen->toJson();
   json["siteProfile"] = _siteProfile->toJson();
@@ -452,77 +476,192 @@ void SiteResponseModel::run() {
                                     .arg(siteCount)
                                     .arg(motionCount));
 
+  // Pool of threads used to compute the trials
+  QThreadPool threadPool;
+  threadPool.setMaxThreadCount(
+      _threadCount > 0 ? _threadCount : QThread::idealThreadCount());
+
+  QList<AbstractMotion *> motions;
+  for (int j = 0; j < _motionLibrary->rowCount(); ++j) {
+    // Skip the disabled motion
+    if (_motionLibrary->motionAt(j)->enabled())
+      motions << _motionLibrary->motionAt(j);
+  }
+
+  // Several realizations are computed at the same time so that all of the
+  // threads are used, even with a few motions. Each realization needs its own
+  // generator, as the calculations use the soil types and layers of the
+  // generator.
+  const int trialsPerSite = std::max<int>(1, motions.size());
+  const int realizationCount =
+      1 + (threadPool.maxThreadCount() + trialsPerSite - 1) / trialsPerSite;
+  const int generatorCount = std::min(siteCount, realizationCount);
+  QList<SoilProfile *> generators;
+  for (int i = 0; i < generatorCount; ++i)
+    generators << SoilProfile::createGenerator(_siteProfile);
+  QList<SoilProfile *> idleGenerators = generators;
+
+  // Converged strains of each motion from the previous realization. These are
+  // used to start the calculation of the same motion in the next realization,
+  // which keeps the results independent of the number of threads.
+  QVector<AbstractIterativeCalculator::StrainProfile> warmStarts(
+      motions.size());
+  auto *iterCalc = qobject_cast<AbstractIterativeCalculator *>(_calculator);
+  const bool useWarmStart = iterCalc && iterCalc->useWarmStart();
+  // Number of trials and iterations with and without a warm start
+  int coldTrials = 0;
+  int coldIterations = 0;
+  int warmTrials = 0;
+  int warmIterations = 0;
+
+  // Signaled by the trials when they finish
+  QMutex trialMutex;
+  QWaitCondition trialFinished;
+
+  auto startTrials = [&](Realization *r) {
+    r->started = true;
+    r->running = motions.size();
+    for (int j = 0; j < motions.size(); ++j) {
+      threadPool.start([this, r, j, &motions, &trialMutex, &trialFinished,
+                        warmStart = warmStarts.at(j)]() {
+        TrialResult result = runTrial(r, j, motions.at(j), warmStart);
+
+        QMutexLocker locker(&trialMutex);
+        r->trials[j] = result;
+        --r->running;
+        trialFinished.wakeAll();
+      });
+    }
+  };
+
+  // Realizations in the order they were generated
+  QList<Realization *> pending;
+
   int count = 0;
-  for (int i = 0; i < siteCount; ++i) {
-    // Break if not okay to continue
+  int savedSiteCount = 0;
+  // Index of the generated realization, including the realizations that
+  // are removed because the calculation failed
+  quint32 realization = 0;
+  while (_okToContinue && savedSiteCount < siteCount) {
+    // Generate the realizations that may be needed. The realizations are
+    // created one at a time on this thread so that the sequence of random
+    // numbers does not depend on the number of threads.
+    while (_okToContinue && !idleGenerators.isEmpty() &&
+           savedSiteCount + pending.size() < siteCount) {
+      auto *r = new Realization;
+      r->generator = idleGenerators.takeFirst();
+
+      TextLog textLog;
+      textLog.setLevel(_outputCatalog->log()->level());
+
+      // Create the sublayers -- this randomizes the properties
+      _randNumGen->setRealization(realization++);
+      r->generator->createSubLayers(&textLog);
+      r->log = textLog.text();
+      r->depth = _outputCatalog->prepareResults(
+          r->generator->subLayers().last().depthToBase());
+      r->trials.resize(motions.size());
+
+      pending << r;
+      // Warm starts use the strains of the previous realization, so the
+      // trials wait for it to be saved
+      if (!useWarmStart || pending.size() == 1)
+        startTrials(r);
+    }
+
+    if (pending.isEmpty())
+      break;
+
+    // Save the results of the oldest realization, which has been started
+    Realization *r = pending.takeFirst();
+    {
+      QMutexLocker locker(&trialMutex);
+      while (r->running > 0)
+        trialFinished.wait(&trialMutex);
+    }
+    idleGenerators << r->generator;
+
     if (!_okToContinue) {
+      // Break if not okay to continue
+      delete r;
       break;
     }
 
     _outputCatalog->log()->append(
         QString(tr("[%1 of %2] Generating site and soil properties"))
-            .arg(i + 1)
+            .arg(savedSiteCount + 1)
             .arg(siteCount));
+    for (const QString &line : std::as_const(r->log))
+      _outputCatalog->log()->append(line);
 
-    // Create the sublayers -- this randomizes the properties
-    _siteProfile->createSubLayers(_outputCatalog->log());
-
-    // FIXME -- check the site profile to ensure that the waves can be
-    // computed for the intial coniditions
-    int motionCountOffset = 0;
-    bool profileResultsSaved = false;
-    for (int j = 0; j < _motionLibrary->rowCount(); ++j) {
-      if (!_motionLibrary->motionAt(j)->enabled()) {
-        // Skip the disabled motion
-        ++motionCountOffset;
-        continue;
-      }
-
-      if (!_okToContinue) {
-        // Break if not okay to continue
-        break;
-      }
-
+    // Merge the trials in the order of the motions
+    bool siteOk = true;
+    for (int j = 0; j < r->trials.size(); ++j) {
       // Output status
       _outputCatalog->log()->append(
           QString(tr("\t[%1 of %2] Computing site response for motion: %3"))
-              .arg(j - motionCountOffset + 1)
+              .arg(j + 1)
               .arg(motionCount)
-              .arg(_motionLibrary->motionAt(j)->name()));
-
-      // Compute the site response
-      bool calcOk = _calculator->run(_motionLibrary->motionAt(j), _siteProfile);
-
-      if (!calcOk || (_siteProfile->onlyConverged() &&
-                      _calculator->status() == NoConvergence)) {
-        if (siteCount > 1) {
-          // Error in the calculation -- need to remove the site
-          _outputCatalog->log()->append(
-              tr("\tCalculation failed -- removing site."));
-          // Remove the results if they were saved
-          if (profileResultsSaved) {
-            _outputCatalog->removeLastSite();
-          }
-          // Reset site count and try once again
-          --i;
-          // Stop iterating over motions
-          break;
-        } else {
-          _okToContinue = false;
-          break;
+              .arg(motions.at(j)->name()));
+
+      for (const QString &line : r->trials.at(j).log)
+        _outputCatalog->log()->append(line);
+
+      if (!r->trials.at(j).ok) {
+        siteOk = false;
+        break;
+      }
+    }
+
+    if (siteOk) {
+      for (int j = 0; j < r->trials.size(); ++j) {
+        // Generate the output
+        _outputCatalog->saveResults(j, r->trials.at(j).data);
+
+        const TrialResult &trial = r->trials.at(j);
+        if (trial.warmStarted) {
+          ++warmTrials;
+          warmIterations += trial.iterations;
+        } else if (trial.iterations > 0) {
+          ++coldTrials;
+          coldIterations += trial.iterations;
         }
+        if (!trial.strainProfile.strains.isEmpty()) {
+          warmStarts[j] = trial.strainProfile;
+        }
+        // Increment the progress bar
+        ++count;
+        emit progressChanged(count);
       }
+      ++savedSiteCount;
+    } else if (siteCount > 1) {
+      // Error in the calculation -- need to remove the site. Another
+      // realization is generated in its place.
+      _outputCatalog->log()->append(
+          tr("\tCalculation failed -- removing site."));
+    } else {
+      _okToContinue = false;
+    }
+    delete r;
+
+    if (useWarmStart && !pending.isEmpty() && !pending.first()->started)
+      startTrials(pending.first());
+  }
 
-      // Generate the output
-      _outputCatalog->saveResults(j - motionCountOffset, _calculator);
-      profileResultsSaved = true;
-      // Increment the progress bar
-      ++count;
-      emit progressChanged(count);
+  // Wait for the trials of canceled realizations
+  threadPool.waitForDone();
+  qDeleteAll(pending);
+  qDeleteAll(generators);
 
-      // Reset the sublayers
-      _siteProfile->resetSubLayers();
-    }
+  if (warmTrials > 0) {
+    _outputCatalog->log()->append(
+        tr("Warm start: %1 iterations per trial (%2 trials), compared to %3 "
+           "iterations per trial from the initial estimate (%4 trials).")
+            .arg(double(warmIterations) / warmTrials, 0, 'f', 1)
+            .arg(warmTrials)
+            .arg(coldTrials > 0 ? double(coldIterations) / coldTrials : 0., 0,
+                 'f', 1)
+            .arg(coldTrials));
   }
 
   if (_okToContinue) {
@@ -536,6 +675,61 @@ void SiteResponseModel::run() {
   }
 }
 
+auto SiteResponseModel::runTrial(
+    const Realization *realization, int index, AbstractMotion *motion,
+    const AbstractIterativeCalculator::StrainProfile &warmStart)
+    -> TrialResult {
+  TrialResult result;
+
+  TextLog textLog;
+  textLog.setLevel(_outputCatalog->log()->level());
+
+  SoilProfile site(realization->generator);
+
+  AbstractCalculator *calculator = _calculator->duplicate();
+  calculator->setTextLog(&textLog);
+
+  auto *iterCalc = qobject_cast<AbstractIterativeCalculator *>(calculator);
+  if (iterCalc) {
+    iterCalc->setWarmStart(warmStart);
+    result.warmStarted =
+        iterCalc->useWarmStart() && !warmStart.strains.isEmpty();
+  }
+
+  {
+    QMutexLocker locker(&_activeCalculatorsMutex);
+    _activeCalculators << calculator;
+  }
+
+  if (_okToContinue) {
+    const bool calcOk = calculator->run(motion, &site);
+
+    result.ok = calcOk && !(site.onlyConverged() &&
+                            calculator->status() == NoConvergence);
+
+    if (result.ok)
+      result.data =
+          _outputCatalog->extractResults(index, calculator, realization->depth);
+
+    if (iterCalc) {
+      result.iterations = iterCalc->iterationCount();
+      // Only converged strains are used to start later calculations
+      if (iterCalc->useWarmStart() && iterCalc->status() == Successful)
+        result.strainProfile = iterCalc->strainProfile();
+    }
+  }
+
+  {
+    QMutexLocker locker(&_activeCalculatorsMutex);
+    _activeCalculators.removeOne(calculator);
+  }
+
+  delete calculator;
+  result.log = textLog.text();
+
+  return result;
+}
+
 auto SiteResponseModel::toHtml() -> QString {
   QString html;
 
@@ -676,7 +870,7 @@ auto SiteResponseModel::toHtml() -> QString {
 auto operator<<(QDataStream &out, const SiteResponseModel *srm)
     -> QDataStream & {
   out << static_cast<quint8>(
-      3); // Version 3: Qt6 migration with QDataStream version tracking
+      4); // Version 4: Number of threads used in the calculation
 
   out << Units::instance() << srm->_notes->toPlainText()
       << (quint32)srm->_method << srm->_siteProfile << srm->_motionLibrary
@@ -693,6 +887,8 @@ auto operator<<(QDataStream &out, const SiteResponseModel *srm)
     break;
   }
 
+  out << (qint32)srm->_threadCount;
+
   return out;
 }
 
@@ -737,6 +933,12 @@ auto operator>>(QDataStream &in, SiteResponseModel *srm) -> QDataStream & {
     break;
   }
 
+  if (ver > 3) {
+    qint32 threadCount;
+    in >> threadCount;
+    srm->setThreadCount(threadCount);
+  }
+
   // Need to update the other objects that the model has data and should not be
   // editted.
   srm->setHasResults(hasResults);
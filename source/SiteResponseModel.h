@@ -22,15 +22,22 @@
 #ifndef SITE_RESPONSE_MODEL_H_
 #define SITE_RESPONSE_MODEL_H_
 
+#include "AbstractIterativeCalculator.h"
+
 #include <QDataStream>
 #include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
 #include <QThread>
+#include <QVector>
 
 #include <atomic>
 
 class SoilProfile;
 class SiteResponseOutput;
 class AbstractCalculator;
+class AbstractMotion;
 class MotionLibrary;
 class OutputCatalog;
 class MyRandomNumGenerator;
@@ -68,6 +75,11 @@ public:
 
   auto saveAbstractMotionData() const -> bool;
 
+  /*! Number of threads used to compute the trials of a site realization.
+   * A value of 0 uses the number of processor cores.
+   */
+  auto threadCount() const -> int;
+
   auto siteProfile() -> SoilProfile *;
   auto motionLibrary() -> MotionLibrary *;
   auto calculator() -> AbstractCalculator *;
@@ -99,6 +111,7 @@ public slots:
   void setFileName(const QString &fileName);
   void setMethod(int method);
   void setModified(bool modified = true);
+  void setThreadCount(int threadCount);
 
   //! Stop the calculation
   void stop();
@@ -109,6 +122,7 @@ public slots:
 signals:
   void fileNameChanged(const QString &fileName);
   void methodChanged(int method);
+  void threadCountChanged(int threadCount);
   void modifiedChanged(bool modified);
 
   void calculatorChanged(AbstractCalculator *calculator);
@@ -127,12 +141,73 @@ protected slots:
   void setHasResults(bool hasResults);
 
 private:
+  //! Result of the calculation for a single motion
+  struct TrialResult {
+    //! If the calculation was successful and the results should be used
+    bool ok = false;
+
+    //! Log messages of the calculation
+    QStringList log;
+
+    //! Data extracted for each of the outputs
+    QList<QVector<double>> data;
+
+    //! Number of iterations, zero for non-iterative calculators
+    int iterations = 0;
+
+    //! If the calculation started from a previous strain profile
+    bool warmStarted = false;
+
+    //! Converged strains used to start the next realization of the motion
+    AbstractIterativeCalculator::StrainProfile strainProfile;
+  };
+
+  /*! Site realization that is being computed.
+   *
+   * The realizations are generated in order on the calculation thread while
+   * the trials of the previous realizations run on the thread pool. Each
+   * realization uses its own generator profile, which is reused once the
+   * results of the realization are saved.
+   */
+  struct Realization {
+    //! Profile that generated the sublayers of the realization
+    SoilProfile *generator = nullptr;
+
+    //! Log messages of the generation
+    QStringList log;
+
+    //! Depths of the profile outputs
+    QVector<double> depth;
+
+    //! Results of each of the motions
+    QVector<TrialResult> trials;
+
+    //! Number of trials that have not finished
+    int running = 0;
+
+    //! If the trials have been started
+    bool started = false;
+  };
+
   //! Set the calculator -- called by setMethod()
   void setCalculator(AbstractCalculator *calculator);
 
   //! Run the calculation
   void run();
 
+  /*! Compute the site response of a realization for a motion.
+   *
+   * The calculation is performed with a copy of the calculator and sublayers
+   * so that several trials can be computed at the same time.
+   * \param realization the site realization
+   * \param index index of the motion within the enabled motions
+   * \param motion the input motion
+   */
+  auto runTrial(const Realization *realization, int index,
+                AbstractMotion *motion,
+                const AbstractIterativeCalculator::StrainProfile &warmStart)
+      -> TrialResult;
+
   //! If the model was modified since the last save
   bool _modified;
 
@@ -157,6 +232,15 @@ private:
   //! Okay to continue calculation.
   std::atomic<bool> _okToContinue;
 
+  //! Number of threads used in the calculation
+  int _threadCount;
+
+  //! Calculators that are currently running, so they can be stopped
+  QList<AbstractCalculator *> _activeCalculators;
+
+  //! Protects _activeCalculators
+  QMutex _activeCalculatorsMutex;
+
   //! A list of motions
   MotionLibrary *_motionLibrary;
 
@@ -31,7 +31,9 @@ SoilLayer::SoilLayer(QObject *parent) : VelocityLayer(parent) {
   _soilType = nullptr;
 }
 
-SoilLayer::SoilLayer(const SoilLayer *other) {
+SoilLayer::SoilLayer(const SoilLayer *other) { assign(other); }
+
+void SoilLayer::assign(const SoilLayer *other) {
   // Abstract Distribution
   _avg = other->avg();
   _varied = other->shearVel();
@@ -46,6 +46,9 @@ public:
 
   explicit SoilLayer(const SoilLayer *soilLayer);
 
+  //! Copy the properties of another soil layer
+  void assign(const SoilLayer *other);
+
   auto soilType() const -> SoilType *;
   void setSoilType(SoilType *soilType);
 
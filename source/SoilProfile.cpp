@@ -51,18 +51,23 @@
 #include <cmath>
 
 SoilProfile::SoilProfile(SiteResponseModel *parent)
-    : MyAbstractTableModel(parent), _siteResponseModel(parent) {
+    : SoilProfile(parent, parent) {}
+
+SoilProfile::SoilProfile(SiteResponseModel *siteResponseModel,
+                         QObject *parent)
+    : MyAbstractTableModel(parent), _siteResponseModel(siteResponseModel) {
   MyRandomNumGenerator *randNumGen = _siteResponseModel->randNumGen();
 
   _bedrock = new RockLayer;
   connect(_bedrock, &RockLayer::wasModified, this, &SoilProfile::wasModified);
 
-  _profileRandomizer = new ProfileRandomizer(randNumGen->gsl_pointer(), this);
+  _profileRandomizer = new ProfileRandomizer(randNumGen, this);
   connect(_profileRandomizer, &ProfileRandomizer::wasModified, this,
           &SoilProfile::wasModified);
 
-  _nonlinearPropertyRandomizer =
-      new NonlinearPropertyRandomizer(randNumGen->gsl_pointer(), this);
+  _nonlinearPropertyRandomizer = new NonlinearPropertyRandomizer(
+      randNumGen->gsl_pointer(MyRandomNumGenerator::NonlinearPropertyStream),
+      this);
   connect(_nonlinearPropertyRandomizer,
           &NonlinearPropertyRandomizer::wasModified, this,
           &SoilProfile::wasModified);
@@ -83,15 +88,45 @@ SoilProfile::SoilProfile(SiteResponseModel *parent)
   _disableAutoDiscretization = false;
   _waterTableDepth = 0.;
   _layerSelectionMethod = MidDepth;
+  _isRealizationCopy = false;
+  _soilLayerPoolUsed = 0;
 }
 
+SoilProfile::SoilProfile(const SoilProfile *other)
+    : MyAbstractTableModel(nullptr), _soilLayers(other->_soilLayers),
+      _subLayers(other->_subLayers), _soilLayerPoolUsed(0),
+      _siteResponseModel(other->_siteResponseModel),
+      _soilTypeCatalog(other->_soilTypeCatalog), _bedrock(other->_bedrock),
+      _waterTableDepth(other->_waterTableDepth),
+      _inputDepth(other->_inputDepth), _inputLocation(other->_inputLocation),
+      _profileRandomizer(nullptr), _nonlinearPropertyRandomizer(nullptr),
+      _isVaried(other->_isVaried), _profileCount(other->_profileCount),
+      _layerSelectionMethod(other->_layerSelectionMethod),
+      _onlyConverged(other->_onlyConverged), _rng(nullptr),
+      _maxFreq(other->_maxFreq), _waveFraction(other->_waveFraction),
+      _disableAutoDiscretization(other->_disableAutoDiscretization),
+      _isRealizationCopy(true) {}
+
 SoilProfile::~SoilProfile() {
+  if (_isRealizationCopy)
+    return;
+
+  qDeleteAll(_soilLayerPool);
   delete _profileRandomizer;
   delete _nonlinearPropertyRandomizer;
   delete _bedrock;
   delete _soilTypeCatalog;
 }
 
+auto SoilProfile::createGenerator(const SoilProfile *other)
+    -> SoilProfile * {
+  auto *profile = new SoilProfile(other->_siteResponseModel, nullptr);
+  profile->fromJson(other->toJson());
+  // Not saved with the project
+  profile->_layerSelectionMethod = other->_layerSelectionMethod;
+  return profile;
+}
+
 auto SoilProfile::rowCount(const QModelIndex &parent) const -> int {
   Q_UNUSED(parent);
 
@@ -492,27 +527,12 @@ auto SoilProfile::soilLayerNameList() const -> QStringList {
 }
 
 void SoilProfile::createSubLayers(TextLog *textLog) {
-  // Clear the previously generated sublayers and delete the soillayers if
-  // they are not the used defined values.  This could be improved as it runs
-  // regardless of it is really needed. FIXME
-  if (!_subLayers.isEmpty()) {
-    QList<SoilLayer *> soilLayers;
-
-    // Create a list of unique soilLayers
-    foreach (SubLayer sl, _subLayers) {
-      if (!soilLayers.contains(sl.soilLayer()))
-        soilLayers << sl.soilLayer();
-    }
-
-    // Delete the SoilLayers created in the process of randomizing the site
-    foreach (SoilLayer *sl, soilLayers) {
-      if (!_soilLayers.contains(sl))
-        delete sl;
-    }
-
-    // Clear the sublayers
-    _subLayers.clear();
-  }
+  // Release the SoilLayers created in the process of randomizing the
+  // previous site, and clear the layer lists. These keep their storage so
+  // that the next realization is created without allocating.
+  _soilLayerPoolUsed = 0;
+  _subLayers.clear();
+  _variedSoilLayers.clear();
 
   // Vary the nonlinear properties of the SoilTypes
   if (_nonlinearPropertyRandomizer->enabled()) {
@@ -566,18 +586,18 @@ void SoilProfile::createSubLayers(TextLog *textLog) {
   }
 
   // Vary the layering
-  QList<SoilLayer *> soilLayers;
+  QList<SoilLayer *> &soilLayers = _variedSoilLayers;
   if (_profileRandomizer->layerThicknessVariation()->enabled()) {
     if (textLog->level() > TextLog::Low) {
       textLog->append(QObject::tr("Varying the layering"));
     }
     // Randomize the layer thicknesses
-    QList<double> thicknesses =
-        _profileRandomizer->layerThicknessVariation()->vary(depthToBedrock);
+    _profileRandomizer->layerThicknessVariation()->vary(depthToBedrock,
+                                                        _layerThicknesses);
 
     // For each thickness, determine the representative soil layer
     double depth = 0;
-    foreach (double thickness, thicknesses) {
+    foreach (double thickness, _layerThicknesses) {
       soilLayers << createRepresentativeSoilLayer(depth, depth + thickness);
       // Set the new depth and thickness
       soilLayers.last()->setDepth(depth);
@@ -591,7 +611,7 @@ void SoilProfile::createSubLayers(TextLog *textLog) {
       foreach (SoilLayer *layer, _soilLayers) {
         if (layer->depthToBase() > depthToBedrock) {
           // Create a new SoilLayer since the thickness will be modified
-          soilLayers << new SoilLayer(layer);
+          soilLayers << acquireSoilLayer(layer);
 
           // Truncate the last SoilLayer once the depth to the bedrock is
           // exceeded
@@ -607,13 +627,14 @@ void SoilProfile::createSubLayers(TextLog *textLog) {
       // Add thickness to the last layer if needed
       if (soilLayers.last()->depthToBase() < depthToBedrock) {
         // Replace the last SoilLayer with a copy
-        soilLayers << new SoilLayer(soilLayers.takeLast());
+        soilLayers << acquireSoilLayer(soilLayers.takeLast());
         soilLayers.last()->setThickness(depthToBedrock -
                                         soilLayers.last()->depth());
       }
     } else {
-      // Copy over previous soil layers
-      soilLayers = _soilLayers;
+      // Copy over previous soil layers. The elements are appended so that
+      // the list does not share, and later release, the data of _soilLayers.
+      soilLayers.append(_soilLayers);
     }
   }
 
@@ -1055,7 +1076,7 @@ auto SoilProfile::createRepresentativeSoilLayer(double top, double base)
 
     // If the layer is deeper than the site profile, use the deepest layer
     if (top > _soilLayers.last()->depthToBase())
-      return new SoilLayer(_soilLayers.last());
+      return acquireSoilLayer(_soilLayers.last());
 
     for (SoilLayer *sl : std::as_const(_soilLayers)) {
       // Skip the layer if it isn't in the depth range of interest
@@ -1091,27 +1112,34 @@ auto SoilProfile::createRepresentativeSoilLayer(double top, double base)
     }
 
     Q_ASSERT(selectedLayer);
-    return new SoilLayer(selectedLayer);
+    return acquireSoilLayer(selectedLayer);
   } else if (_layerSelectionMethod == MidDepth) {
     const double midDepth = (top + base) / 2.0;
-    SoilLayer *newLayer = nullptr;
+    // Use the last layer is none are found
+    const SoilLayer *selectedLayer = _soilLayers.last();
 
     // Try each of the layers
     for (SoilLayer *sl : std::as_const(_soilLayers)) {
       if (sl->depth() < midDepth && midDepth <= sl->depthToBase()) {
-        newLayer = new SoilLayer(sl);
+        selectedLayer = sl;
       }
     }
-    // Use the last layer is none are found
-    if (!newLayer)
-      newLayer = new SoilLayer(_soilLayers.last());
 
-    return newLayer;
+    return acquireSoilLayer(selectedLayer);
   }
 
   return nullptr;
 }
 
+auto SoilProfile::acquireSoilLayer(const SoilLayer *other) -> SoilLayer * {
+  if (_soilLayerPoolUsed == _soilLayerPool.size()) {
+    _soilLayerPool << new SoilLayer(other);
+  } else {
+    _soilLayerPool.at(_soilLayerPoolUsed)->assign(other);
+  }
+  return _soilLayerPool.at(_soilLayerPoolUsed++);
+}
+
 void SoilProfile::updateUnits() {
   emit headerDataChanged(Qt::Horizontal, DepthColumn, MaxColumn);
 }
@@ -52,8 +52,26 @@ class SoilProfile : public MyAbstractTableModel {
 
 public:
   explicit SoilProfile(SiteResponseModel *parent = nullptr);
+
+  /*! Create a copy of the current realization of the profile.
+   *
+   * The copy has its own sublayers, so that a calculation can modify them
+   * without changing \a other. The soil layers, soil types, and bedrock are
+   * shared with \a other and must not be modified while the copy exists.
+   */
+  explicit SoilProfile(const SoilProfile *other);
   ~SoilProfile();
 
+  /*! Create an independent copy of \a other to generate realizations.
+   *
+   * The copy has its own soil types, soil layers, and bedrock, so that it
+   * can create a realization while calculations use the realizations of
+   * other copies. The random numbers are drawn from the same generators as
+   * \a other. The copy has no parent, so that it may be created on any
+   * thread.
+   */
+  static auto createGenerator(const SoilProfile *other) -> SoilProfile *;
+
   //! Columns of the table
   enum Column {
     DepthColumn,
@@ -213,9 +231,17 @@ protected slots:
   void updateUnits();
 
 private:
+  SoilProfile(SiteResponseModel *siteResponseModel, QObject *parent);
+
   //! Return the layer with the longest travel time between the two depths
   auto createRepresentativeSoilLayer(double top, double base) -> SoilLayer *;
 
+  /*! Copy of a soil layer from the pool.
+   * The copy is valid until the next realization is created, which releases
+   * all of the layers of the pool at once.
+   */
+  auto acquireSoilLayer(const SoilLayer *other) -> SoilLayer *;
+
   /*! Return the velocity layer at a given index.
    * Combines both the soil layers and rock layer
    */
@@ -231,6 +257,18 @@ private:
   QList<SoilLayer *> _soilLayers;
   QList<SubLayer> _subLayers;
 
+  //! Pool of the soil layers created while varying the profile. The layers
+  //! are reused by each realization and deleted with the profile.
+  QList<SoilLayer *> _soilLayerPool;
+
+  //! Number of soil layers of the pool used by the current realization
+  int _soilLayerPoolUsed;
+
+  //! Soil layers and varied thicknesses of the current realization, kept
+  //! between realizations for their storage
+  QList<SoilLayer *> _variedSoilLayers;
+  QList<double> _layerThicknesses;
+
   //! Parent site response model
   SiteResponseModel *_siteResponseModel;
 
@@ -294,5 +332,8 @@ private:
   //! Disable the layer discretization and use the layering provided
   bool _disableAutoDiscretization;
   //@}
+
+  //! If the profile is a copy of a realization and doesn't own its layers
+  bool _isRealizationCopy;
 };
 #endif
@@ -113,6 +113,23 @@ bool SubLayer::interp(double strain, double *modulus, double *damping) const {
   return true;
 }
 
+auto SubLayer::interp(const QVector<double> &strains, QVector<double> &moduli,
+                      QVector<double> &dampings) const -> bool {
+  auto soilType = _soilLayer->soilType();
+
+  soilType->modulusModel()->interp(strains, moduli);
+  soilType->dampingModel()->interp(strains, dampings);
+
+  const double shearModMax = initialShearMod();
+  for (double &modulus : moduli) {
+    modulus *= shearModMax;
+  }
+
+  return strains.isEmpty() ||
+         *std::max_element(strains.constBegin(), strains.constEnd()) <=
+             _soilLayer->strainLimit();
+}
+
 void SubLayer::setInitialStrain(double strain) {
   _normShearMod = _soilLayer->soilType()->modulusModel()->interp(strain);
   _shearMod = initialShearMod() * _normShearMod;
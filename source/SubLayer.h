@@ -81,6 +81,13 @@ public:
   //! Interpolation using the curves
   bool interp(double strain, double *modulus, double *damping) const;
 
+  /*! Interpolation using the curves for each of the strains
+   * \return false if any of the strains exceeds the strain limit, the
+   * properties are computed for all of the strains
+   */
+  auto interp(const QVector<double> &strains, QVector<double> &moduli,
+              QVector<double> &dampings) const -> bool;
+
   //! Compute the properties from an initial estimate of strain
   void setInitialStrain(double strain);
 
@@ -21,6 +21,8 @@
 
 #include "TimeSeriesMotion.h"
 
+#include "FourierTransform.h"
+#include "MotionCache.h"
 #include "ResponseSpectrum.h"
 #include "Serialize.h"
 #include "Units.h"
@@ -32,24 +34,118 @@
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonValue>
+#include <QMap>
 #include <QRegularExpression>
-#include <QTextStream>
-
-#ifdef USE_FFTW
-#include <fftw3.h>
-#else
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_fft_halfcomplex.h>
-#include <gsl/gsl_fft_real.h>
-#endif
 
 #include <gsl/gsl_multifit.h>
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+//! Lines of a text buffer, which are read without copying them
+class LineReader {
+public:
+  LineReader(const char *begin, const char *end) : _pos(begin), _end(end) {}
+
+  //! If all of the lines have been read
+  auto atEnd() const -> bool { return _pos >= _end; }
+
+  /*! Advance to the next line
+   *
+   * \param lineBegin start of the line
+   * \param lineEnd end of the line, without the end of line characters
+   */
+  void next(const char **lineBegin, const char **lineEnd) {
+    const auto *newline =
+        static_cast<const char *>(memchr(_pos, '\n', _end - _pos));
+    const char *end = newline ? newline : _end;
+
+    *lineBegin = _pos;
+    _pos = newline ? newline + 1 : _end;
+
+    if (end > *lineBegin && end[-1] == '\r')
+      --end;
+    *lineEnd = end;
+  }
+
+  //! Advance to the next line and return a copy of it
+  auto nextString() -> QString {
+    const char *lineBegin;
+    const char *lineEnd;
+    next(&lineBegin, &lineEnd);
+    return QString::fromUtf8(lineBegin, lineEnd - lineBegin);
+  }
+
+private:
+  const char *_pos;
+  const char *_end;
+};
+
+inline auto isNumberChar(char c) -> bool {
+  return ('0' <= c && c <= '9') || c == '.';
+}
+
+/*! Find the next number in a line
+ *
+ * Numbers match the pattern -?[0-9.]+([eE][+-]?[0-9]+)? and all other
+ * characters separate the numbers.
+ * \return if a number was found
+ */
+auto findNumber(const char *pos, const char *end, const char **numberBegin,
+                const char **numberEnd) -> bool {
+  // Find the start of the number
+  while (pos < end && !isNumberChar(*pos) &&
+         !(*pos == '-' && pos + 1 < end && isNumberChar(pos[1])))
+    ++pos;
+
+  if (pos == end)
+    return false;
+
+  *numberBegin = pos;
+  if (*pos == '-')
+    ++pos;
+
+  while (pos < end && isNumberChar(*pos))
+    ++pos;
+
+  // Optional exponent, which requires at least one digit
+  if (pos < end && (*pos == 'e' || *pos == 'E')) {
+    const char *exp = pos + 1;
+    if (exp < end && (*exp == '+' || *exp == '-'))
+      ++exp;
+
+    if (exp < end && '0' <= *exp && *exp <= '9') {
+      pos = exp;
+      while (pos < end && '0' <= *pos && *pos <= '9')
+        ++pos;
+    }
+  }
+
+  *numberEnd = pos;
+  return true;
+}
+
+//! Convert the complete text of a number, independent of the locale
+auto parseNumber(const char *begin, const char *end, double *value) -> bool {
+#if defined(__cpp_lib_to_chars)
+  const std::from_chars_result result = std::from_chars(begin, end, *value);
+  return result.ec == std::errc() && result.ptr == end;
+#else
+  bool ok;
+  *value = QByteArray::fromRawData(begin, end - begin).toDouble(&ok);
+  return ok;
+#endif
+}
+} // namespace
 
 TimeSeriesMotion::TimeSeriesMotion(QObject *parent) : AbstractMotion(parent) {
   _isLoaded = false;
   _saveData = true;
+  _responseSpectrumMethod = FrequencyDomain;
   // Initialize the values -- appropriate values for an AT2 file
   _inputUnits = Gravity;
   _timeStep = 0;
@@ -67,6 +163,7 @@ TimeSeriesMotion::TimeSeriesMotion(const QString &fileName, double scale,
     : AbstractMotion(parent), _fileName(QDir::cleanPath(fileName)) {
   _isLoaded = false;
   _saveData = true;
+  _responseSpectrumMethod = FrequencyDomain;
   _type = type;
   // Initialize the values -- appropriate values for an AT2 file
   _inputUnits = Gravity;
@@ -91,6 +188,10 @@ auto TimeSeriesMotion::formatList() -> QStringList {
   return QStringList() << tr("Rows") << tr("Columns");
 }
 
+auto TimeSeriesMotion::responseSpectrumMethodList() -> QStringList {
+  return QStringList() << tr("Frequency domain") << tr("Time domain");
+}
+
 auto TimeSeriesMotion::fileName() const -> QString { return _fileName; }
 
 void TimeSeriesMotion::setFileName(QString fileName) {
@@ -366,12 +467,25 @@ auto TimeSeriesMotion::load(const QString &fileName, bool defaults,
 
   // Load the file
   QFile file(_fileName);
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  if (!file.open(QIODevice::ReadOnly)) {
     qWarning() << "Unable to open the time series file:"
                << qPrintable(_fileName);
     return false;
   }
-  QTextStream stream(&file);
+
+  // Map the file into memory, or read it if it cannot be mapped
+  QByteArray contents;
+  const char *begin = reinterpret_cast<const char *>(file.map(0, file.size()));
+  const char *end = nullptr;
+  if (begin) {
+    end = begin + file.size();
+  } else {
+    contents = file.readAll();
+    begin = contents.constData();
+    end = begin + contents.size();
+  }
+
+  LineReader lines(begin, end);
 
   if (defaults) {
     if (ext == "AT2") {
@@ -382,9 +496,9 @@ auto TimeSeriesMotion::load(const QString &fileName, bool defaults,
       setScale(scale);
 
       // Read in the header information
-      Q_UNUSED(stream.readLine());
-      setDescription(stream.readLine());
-      Q_UNUSED(stream.readLine());
+      Q_UNUSED(lines.nextString());
+      setDescription(lines.nextString());
+      Q_UNUSED(lines.nextString());
 
       QList<QRegularExpression> patterns = {
           // Example: 8751    0.0040    NPTS, DT
@@ -394,7 +508,7 @@ auto TimeSeriesMotion::load(const QString &fileName, bool defaults,
           QRegularExpression("NPTS=\\s+(\\d+), DT=\\s+([0-9.]+) SEC,?"),
       };
 
-      QString line = stream.readLine();
+      const QString line = lines.nextString();
       bool success = false;
       for (const QRegularExpression &pattern : patterns) {
         QRegularExpressionMatch match = pattern.match(line);
@@ -454,26 +568,29 @@ auto TimeSeriesMotion::load(const QString &fileName, bool defaults,
     }
   }
 
-  // Move back to the start of the stream
-  stream.seek(0);
+  // Move back to the start of the file
+  lines = LineReader(begin, end);
 
   int lineNum = 1;
   // Skip the header lines
-  while (lineNum < _startLine) {
-    Q_UNUSED(stream.readLine());
+  while (lineNum < _startLine && !lines.atEnd()) {
+    const char *lineBegin;
+    const char *lineEnd;
+    lines.next(&lineBegin, &lineEnd);
     ++lineNum;
   }
 
-  // Read the first line
-  QString line = stream.readLine();
-
   bool finished = false;
   bool stopLineReached = false;
 
   // Modify the scale for unit conversion
   scale = unitConversionFactor() * _scale;
 
-  while (!finished && !line.isNull()) {
+  // Size the buffer for the expected number of points
+  if (_pointCount > 0)
+    _accel.reserve(_pointCount);
+
+  while (!finished && !lines.atEnd()) {
     // Stop if line exceeds number of lines.  The line number has
     // to be increased by one because the user display starts at
     // line number 1 instead of 0
@@ -482,62 +599,51 @@ auto TimeSeriesMotion::load(const QString &fileName, bool defaults,
       break;
     }
 
-    // Read the line and split the line
-    static const QRegularExpression rx("(-?[0-9.]+(?:[eE][+-]?\\d+)?)");
-    QStringList row;
-    QRegularExpressionMatchIterator it = rx.globalMatch(line);
-    while (it.hasNext()) {
-      QRegularExpressionMatch match = it.next();
-      row << match.captured(1);
-    }
+    const char *lineBegin;
+    const char *lineEnd;
+    lines.next(&lineBegin, &lineEnd);
+
+    // Parse the numbers of the line in place. With the column format, only
+    // the data column is used and the line may be shorter at the end of the
+    // file.
+    const char *pos = lineBegin;
+    const char *numberBegin;
+    const char *numberEnd;
+    int column = 0;
+    bool ok = true;
+    while (findNumber(pos, lineEnd, &numberBegin, &numberEnd)) {
+      pos = numberEnd;
+      ++column;
+
+      if (_format == Columns && column != _dataColumn)
+        continue;
 
-    // Process the row based on the format
-    bool ok;
-    switch (_format) {
-    case Rows:
-      // Use all parts of the data
-      for (int i = 0; i < row.size(); ++i) {
-        if (_pointCount && _accel.size() >= _pointCount) {
-          qWarning("Point count reached before end of data!");
-          finished = true;
-          break;
-        }
-        // Apply the scale factor and read the acceleration
-        _accel << scale * row.at(i).trimmed().toDouble(&ok);
-        // Stop if there was an error in the conversion
-        if (!ok) {
-          continue;
-        }
-      }
-      break;
-    case Columns:
       if (_pointCount && _accel.size() >= _pointCount) {
         qWarning("Point count reached before end of data!");
         finished = true;
         break;
       }
-      // Use only the important column, however at the end of the
-      // file that column may not exist -- this only happens when the
-      // row format is applied, but it still causes the program to
-      // crash.
-      if (_dataColumn - 1 < row.size()) {
-        _accel << scale * row.at(_dataColumn - 1).trimmed().toDouble(&ok);
-      }
-      break;
+
+      // Apply the scale factor and read the acceleration
+      double value;
+      ok = parseNumber(numberBegin, numberEnd, &value);
+      if (!ok)
+        break;
+
+      _accel << scale * value;
+
+      if (_format == Columns)
+        break;
     }
+
     // Throw an error if there was a problem
     if (!ok) {
       qCritical() << "Error converting string to double in line: \n\""
-                  << qPrintable(line) << "\"\nCheck starting line.";
+                  << qPrintable(QString::fromUtf8(lineBegin,
+                                                  lineEnd - lineBegin))
+                  << "\"\nCheck starting line.";
       return false;
     }
-
-    if (stream.atEnd()) {
-      break;
-    } else {
-      // Read the next line
-      line = stream.readLine();
-    }
   }
 
   if (_pointCount && _pointCount != _accel.size()) {
@@ -565,6 +671,9 @@ auto TimeSeriesMotion::load(const QString &fileName, bool defaults,
 }
 
 void TimeSeriesMotion::calculate() {
+  // The motion no longer matches the cache entry it was loaded from
+  _cacheKey.clear();
+
   // Compute the next largest power of two
   int n = 1;
   while (n <= _accel.size())
@@ -590,18 +699,121 @@ void TimeSeriesMotion::calculate() {
   // Compute FAS of the velocity time series
   fft(integrate(accel), _fourierVel);
 
+  calculateFreq();
+
+  // Compute PGA and PGV
+  setPga(findMaxAbs(accel));
+  setPgv(findMaxAbs(integrate(accel)) * Units::instance()->tsConv());
+
+  // The response spectrum is only computed when it is needed
+  invalidateRespSpec();
+}
+
+void TimeSeriesMotion::calculateFreq() {
   // Create the frequency array truncated at the maximum frequency
   const double delta = 1 / (2. * _timeStep * (_fourierAcc.size() - 1));
   _freq.resize(_fourierAcc.size());
   for (int i = 0; i < _freq.size(); ++i)
     _freq[i] = i * delta;
+}
 
-  // Compute PGA and PGV
-  setPga(findMaxAbs(accel));
-  setPgv(findMaxAbs(integrate(accel)) * Units::instance()->tsConv());
+auto TimeSeriesMotion::cacheSettings() const -> QByteArray {
+  QByteArray settings;
+  QDataStream out(&settings, QIODevice::WriteOnly);
+
+  out << _timeStep << _pointCount << _scale << (qint32)_inputUnits
+      << (qint32)_format << _dataColumn << _startLine << _stopLine
+      << (qint32)Units::instance()->system() << (qint32)_responseSpectrumMethod
+      << _respSpec->period() << _respSpec->damping();
 
-  // Compute the response spectrum
-  _respSpec->setSa(computeSa(_respSpec->period(), _respSpec->damping()));
+  return settings;
+}
+
+void TimeSeriesMotion::loadCached() {
+  // The key is computed before loading, which may set the point count and
+  // stop line
+  const QByteArray key = MotionCache::key(_fileName, cacheSettings());
+  _cacheKey.clear();
+
+  MotionCache::Entry entry;
+  if (!key.isEmpty() && MotionCache::read(key, &entry)) {
+    _pointCount = entry.pointCount;
+    _stopLine = entry.stopLine;
+    _accel = entry.accel;
+    _fourierAcc = entry.fourierAcc;
+    _fourierVel = entry.fourierVel;
+    calculateFreq();
+
+    setPga(entry.pga);
+    setPgv(entry.pgv);
+
+    // The spectrum is only saved if it was computed, otherwise it is saved
+    // once it has been
+    if (entry.sa.isEmpty()) {
+      invalidateRespSpec();
+      _cacheKey = key;
+      _cacheSettings = cacheSettings();
+    } else {
+      setRespSpecSa(entry.sa);
+    }
+
+    _isLoaded = true;
+    return;
+  }
+
+  if (load(_fileName, false, _scale)) {
+    if (!key.isEmpty()) {
+      entry.pointCount = _pointCount;
+      entry.stopLine = _stopLine;
+      entry.pga = _pga;
+      entry.pgv = _pgv;
+      entry.accel = _accel;
+      entry.fourierAcc = _fourierAcc;
+      entry.fourierVel = _fourierVel;
+      if (!respSpecIsStale())
+        entry.sa = _respSpec->sa();
+
+      if (!MotionCache::write(key, entry)) {
+        qWarning() << "Unable to save the motion cache for:"
+                   << qPrintable(_fileName);
+      } else if (entry.sa.isEmpty()) {
+        _cacheKey = key;
+        _cacheSettings = cacheSettings();
+      }
+    }
+  } else if (_accel.size()) {
+    // Use the data that was read before the error
+    calculate();
+    _isLoaded = true;
+  }
+}
+
+void TimeSeriesMotion::saveCachedRespSpec() {
+  if (_cacheKey.isEmpty() || respSpecIsStale())
+    return;
+
+  // Only one attempt is made for each entry
+  const QByteArray key = _cacheKey;
+  _cacheKey.clear();
+
+  // The settings, such as the periods of the response spectrum, may have
+  // changed without reloading the motion
+  if (_saveData || cacheSettings() != _cacheSettings)
+    return;
+
+  MotionCache::Entry entry;
+  entry.pointCount = _pointCount;
+  entry.stopLine = _stopLine;
+  entry.pga = _pga;
+  entry.pgv = _pgv;
+  entry.accel = _accel;
+  entry.fourierAcc = _fourierAcc;
+  entry.fourierVel = _fourierVel;
+  entry.sa = _respSpec->sa();
+
+  if (!MotionCache::write(key, entry))
+    qWarning() << "Unable to save the motion cache for:"
+               << qPrintable(_fileName);
 }
 
 auto TimeSeriesMotion::rowCount(const QModelIndex &parent) const -> int {
@@ -651,10 +863,29 @@ auto TimeSeriesMotion::headerData(int section, Qt::Orientation orientation,
   return QVariant();
 }
 
+void TimeSeriesMotion::setRespSpecSa(const QVector<double> &sa) {
+  AbstractMotion::setRespSpecSa(sa);
+  saveCachedRespSpec();
+}
+
 void TimeSeriesMotion::setSaveData(bool b) { _saveData = b; }
 
 auto TimeSeriesMotion::saveData() const -> bool { return _saveData; }
 
+auto TimeSeriesMotion::responseSpectrumMethod() const
+    -> ResponseSpectrumMethod {
+  return _responseSpectrumMethod;
+}
+
+void TimeSeriesMotion::setResponseSpectrumMethod(
+    ResponseSpectrumMethod method) {
+  if (_responseSpectrumMethod != method) {
+    _responseSpectrumMethod = method;
+    // The spectral accelerations were computed with the previous method
+    invalidateRespSpec();
+  }
+}
+
 auto TimeSeriesMotion::isLoaded() const -> bool { return _isLoaded; }
 
 void TimeSeriesMotion::setIsLoaded(bool isLoaded) { _isLoaded = isLoaded; }
@@ -673,8 +904,12 @@ auto TimeSeriesMotion::findMaxAbs(const QVector<double> &v) const -> double {
 
 auto TimeSeriesMotion::max(const QVector<std::complex<double>> &tf) const
     -> double {
+  // Reuse the buffer between calls, this is called once per oscillator when
+  // computing response spectra.
+  thread_local QVector<double> ts;
+  calcTimeSeries(_fourierAcc, tf, ts);
   // Return the maximum value in the time history
-  return findMaxAbs(calcTimeSeries(_fourierAcc, tf));
+  return findMaxAbs(ts);
 }
 
 auto TimeSeriesMotion::maxVel(const QVector<std::complex<double>> &tf) const
@@ -693,10 +928,22 @@ auto TimeSeriesMotion::computeSa(const QVector<double> &period, double damping,
   if (!accelTf.isEmpty())
     Q_ASSERT(accelTf.size() == _freq.size());
 
+  if (_responseSpectrumMethod == TimeDomain)
+    return computeSaTimeDomain(period, damping, accelTf);
+
+  return computeSaFrequencyDomain(period, damping, accelTf);
+}
+
+auto TimeSeriesMotion::computeSaFrequencyDomain(
+    const QVector<double> &period, double damping,
+    const QVector<std::complex<double>> &accelTf) const -> QVector<double> {
   QVector<double> sa(period.size());
 
   const double deltaFreq = 1 / (_timeStep * _accel.size());
 
+  const QSharedPointer<const SdofTfBank> bank = sdofTfBank(period, damping);
+  QVector<std::complex<double>> tf;
+
   // Compute the response at each period
   for (int i = 0; i < sa.size(); ++i) {
     /*
@@ -719,27 +966,25 @@ auto TimeSeriesMotion::computeSa(const QVector<double> &period, double damping,
     size += 1;
 
     // Only apply the SDOF transfer function over frequencies defined by the
-    // original motion
-    QVector<std::complex<double>> tf = calcSdofTf(period.at(i), damping);
+    // original motion. The remaining values pad with zeros to achieve the
+    // required point count.
+    const QVector<std::complex<double>> &sdofTf = bank->at(i);
+    tf.fill(std::complex<double>(0., 0.), size);
 
     // The amplitude of the FAS needs to be scaled to reflect the increased
     // number of points.
     const double scale = double(size) / double(_freq.size());
 
-    for (int j = 0; j < tf.size(); ++j)
-      tf[j] *= scale;
+    for (int j = 0; j < sdofTf.size(); ++j)
+      tf[j] = scale * sdofTf.at(j);
 
     // If there is an acceleration transfer function combine the SDOF and
     // acceleration transfer functions
     if (!accelTf.isEmpty()) {
-      for (int j = 0; j < tf.size(); ++j)
+      for (int j = 0; j < sdofTf.size(); ++j)
         tf[j] *= accelTf.at(j);
     }
 
-    // Pad with zeros to achieve the required point count
-    if (tf.size() < size)
-      tf.resize(size);
-
     // Compute the maximum response
     sa[i] = max(tf);
   }
@@ -747,6 +992,98 @@ auto TimeSeriesMotion::computeSa(const QVector<double> &period, double damping,
   return sa;
 }
 
+auto TimeSeriesMotion::computeSaTimeDomain(
+    const QVector<double> &period, double damping,
+    const QVector<std::complex<double>> &accelTf) const -> QVector<double> {
+  QVector<double> sa(period.size());
+
+  // The acceleration time series is only computed once. This includes the
+  // zero padding, which captures the free vibration after the motion ends.
+  QVector<double> accel;
+  calcTimeSeries(_fourierAcc, accelTf, accel);
+
+  const double zeta = damping / 100;
+  const double ratio = zeta / sqrt(1 - zeta * zeta);
+
+  // Oscillators are grouped by the number of substeps required to sample
+  // their response at least ten times per period. Within a group all of the
+  // oscillators are advanced together, which allows the inner loop to be
+  // vectorized by the compiler.
+  QMap<int, QVector<int>> groups;
+  for (int i = 0; i < period.size(); ++i) {
+    const int count = qMax(1, int(ceil(10 * _timeStep / period.at(i))));
+    groups[count] << i;
+  }
+
+  for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+    const int count = it.key();
+    const QVector<int> &indices = it.value();
+    const int n = indices.size();
+    const double h = _timeStep / count;
+
+    // Coefficients of the recurrence for each oscillator:
+    //   x[i+1] = a11 x[i] + a12 v[i] + b11 ag[i] + b12 ag[i+1]
+    //   v[i+1] = a21 x[i] + a22 v[i] + b21 ag[i] + b22 ag[i+1]
+    std::vector<double> a11(n), a12(n), a21(n), a22(n);
+    std::vector<double> b11(n), b12(n), b21(n), b22(n);
+    std::vector<double> omega2(n);
+
+    for (int j = 0; j < n; ++j) {
+      const double w = 2 * M_PI / period.at(indices.at(j));
+      const double wd = w * sqrt(1 - zeta * zeta);
+
+      const double e = exp(-zeta * w * h);
+      const double s = sin(wd * h);
+      const double c = cos(wd * h);
+
+      const double t1 = (2 * zeta * zeta - 1) / (w * w * h);
+      const double t2 = 2 * zeta / (w * w * w * h);
+
+      a11[j] = e * (ratio * s + c);
+      a12[j] = e * s / wd;
+      a21[j] = -w * e * s / sqrt(1 - zeta * zeta);
+      a22[j] = e * (c - ratio * s);
+
+      b11[j] = e * ((t1 + zeta / w) * s / wd + (t2 + 1 / (w * w)) * c) - t2;
+      b12[j] = -e * (t1 * s / wd + t2 * c) - 1 / (w * w) + t2;
+      b21[j] = e * ((t1 + zeta / w) * (c - ratio * s) -
+                    (t2 + 1 / (w * w)) * (wd * s + zeta * w * c)) +
+               1 / (w * w * h);
+      b22[j] = -e * (t1 * (c - ratio * s) - t2 * (wd * s + zeta * w * c)) -
+               1 / (w * w * h);
+
+      omega2[j] = w * w;
+    }
+
+    // Relative displacement, relative velocity, and peak displacement
+    std::vector<double> x(n, 0.), v(n, 0.), peak(n, 0.);
+
+    for (int i = 0; i < accel.size() - 1; ++i) {
+      const double slope = (accel.at(i + 1) - accel.at(i)) / count;
+      for (int k = 0; k < count; ++k) {
+        const double ag0 = accel.at(i) + k * slope;
+        const double ag1 = ag0 + slope;
+
+        for (int j = 0; j < n; ++j) {
+          const double xn = a11[j] * x[j] + a12[j] * v[j] + b11[j] * ag0 +
+                            b12[j] * ag1;
+          const double vn = a21[j] * x[j] + a22[j] * v[j] + b21[j] * ag0 +
+                            b22[j] * ag1;
+          x[j] = xn;
+          v[j] = vn;
+          peak[j] = std::max(peak[j], std::fabs(xn));
+        }
+      }
+    }
+
+    // Pseudo-spectral acceleration
+    for (int j = 0; j < n; ++j)
+      sa[indices.at(j)] = omega2[j] * peak[j];
+  }
+
+  return sa;
+}
+
 auto TimeSeriesMotion::absFourierAcc(
     const QVector<std::complex<double>> &tf) const -> const QVector<double> {
   return absFourier(_fourierAcc, tf);
@@ -930,19 +1267,12 @@ void TimeSeriesMotion::fft(const QVector<double> &in,
       fftw_free(inArray);
       fftw_free(outArray);
   */
-  // Load the buffer with the initial values
+  // Load the per-thread buffer with the initial values
   const int n = in.size();
-  auto *d = new double[n];
-  // Load the data
+  double *d = FourierTransform::workspace(n);
   memcpy(d, in.data(), n * sizeof(double));
 
-#ifdef USE_FFTW
-  fftw_plan p = fftw_plan_r2r_1d(n, d, d, FFTW_R2HC, FFTW_ESTIMATE);
-  fftw_execute(p);
-#else
-  // Execute FFT
-  gsl_fft_real_radix2_transform(d, 1, n);
-#endif
+  FourierTransform::forward(n);
 
   // Load the data into out
   out.resize(1 + n / 2);
@@ -951,9 +1281,6 @@ void TimeSeriesMotion::fft(const QVector<double> &in,
     out[i] = std::complex<double>(d[i], d[n - i]);
   }
   out[out.size() - 1] = std::complex<double>(d[n - 1], 0);
-
-  // Delete the buffer
-  delete[] d;
 }
 
 void TimeSeriesMotion::ifft(const QVector<std::complex<double>> &in,
@@ -989,7 +1316,8 @@ void TimeSeriesMotion::ifft(const QVector<std::complex<double>> &in,
       fftw_free(outArray);
   */
   const int n = 2 * (in.size() - 1);
-  auto *d = new double[n];
+  // Pack the halfcomplex values into the per-thread buffer
+  double *d = FourierTransform::workspace(n);
 
   d[0] = in.first().real();
   for (int i = 1; i < in.size(); ++i) {
@@ -998,44 +1326,45 @@ void TimeSeriesMotion::ifft(const QVector<std::complex<double>> &in,
   }
   d[n / 2] = in.last().real();
 
-#if USE_FFTW
-  fftw_plan p = fftw_plan_r2r_1d(n, d, d, FFTW_HC2R, FFTW_ESTIMATE);
-  fftw_execute(p);
-
-  for (int i = 0; i < n; ++i) {
-    // Scale by n
-    d[i] /= n;
-  }
-#else
-  gsl_fft_halfcomplex_radix2_inverse(d, 1, n);
-#endif
+  FourierTransform::inverse(n);
 
-  // Copy results to output
   out.resize(n);
   memcpy(out.data(), d, n * sizeof(double));
-
-  delete[] d;
 }
 
 auto TimeSeriesMotion::calcTimeSeries(
-    QVector<std::complex<double>> fa,
+    const QVector<std::complex<double>> &fa,
     const QVector<std::complex<double>> &tf) const -> QVector<double> {
-  // Apply the transfer fucntion
-  if (!tf.isEmpty()) {
-    // If needed, zero pad the Fourier amplitudes such that is has the same
-    // length as the incoming transfer function.
-    if (fa.size() < tf.size())
-      fa.resize(tf.size());
+  QVector<double> ts;
+  calcTimeSeries(fa, tf, ts);
+  return ts;
+}
 
-    for (int i = 0; i < fa.size(); ++i)
-      fa[i] *= tf.at(i);
+void TimeSeriesMotion::calcTimeSeries(const QVector<std::complex<double>> &fa,
+                                      const QVector<std::complex<double>> &tf,
+                                      QVector<double> &ts) const {
+  // If needed, zero pad the Fourier amplitudes such that is has the same
+  // length as the incoming transfer function.
+  const int size = tf.isEmpty() ? fa.size() : qMax(fa.size(), tf.size());
+  const int n = 2 * (size - 1);
+
+  double *d = FourierTransform::workspace(n);
+  // Apply the transfer function while packing into the halfcomplex format
+  for (int i = 0; i <= n / 2; ++i) {
+    std::complex<double> c =
+        (i < fa.size()) ? fa.at(i) : std::complex<double>(0, 0);
+    if (!tf.isEmpty())
+      c *= tf.at(i);
+
+    d[i] = c.real();
+    if (0 < i && i < n / 2)
+      d[n - i] = c.imag();
   }
 
-  // Compute the time series
-  QVector<double> ts;
-  ifft(fa, ts);
+  FourierTransform::inverse(n);
 
-  return ts;
+  ts.resize(n);
+  memcpy(ts.data(), d, n * sizeof(double));
 }
 
 void TimeSeriesMotion::fromJson(const QJsonObject &json) {
@@ -1055,13 +1384,13 @@ void TimeSeriesMotion::fromJson(const QJsonObject &json) {
 
   if (_saveData) {
     Serialize::toDoubleVector(json["accel"], _accel);
-  } else {
-    load(_fileName, false, _scale);
-  }
 
-  if (_accel.size()) {
-    calculate();
-    _isLoaded = true;
+    if (_accel.size()) {
+      calculate();
+      _isLoaded = true;
+    }
+  } else {
+    loadCached();
   }
 }
 
@@ -1138,13 +1467,13 @@ auto operator>>(QDataStream &in, TimeSeriesMotion *tsm) -> QDataStream & {
   // Save the data internally if requested
   if (tsm->_saveData) {
     in >> tsm->_accel;
-  } else {
-    tsm->load(tsm->_fileName, false, tsm->_scale);
-  }
 
-  if (tsm->_accel.size()) {
-    tsm->calculate();
-    tsm->_isLoaded = true;
+    if (tsm->_accel.size()) {
+      tsm->calculate();
+      tsm->_isLoaded = true;
+    }
+  } else {
+    tsm->loadCached();
   }
 
   return in;
@@ -59,6 +59,12 @@ public:
                  //!< time series
   };
 
+  //! Method used to compute the response spectrum
+  enum ResponseSpectrumMethod {
+    FrequencyDomain, //!< Inverse FFT of each oscillator response
+    TimeDomain //!< Exact piecewise-linear recurrence (Nigam and Jennings)
+  };
+
   //! Units of the motion
   enum InputUnits {
     Gravity,                     //!< Gravity -- no unit conversion required
@@ -68,6 +74,7 @@ public:
   };
 
   static auto formatList() -> QStringList;
+  static auto responseSpectrumMethodList() -> QStringList;
 
   virtual auto max(const QVector<std::complex<double>> &tf =
                        QVector<std::complex<double>>()) const -> double;
@@ -165,11 +172,17 @@ public:
 
   void setSaveData(bool b);
   auto saveData() const -> bool;
+
+  auto responseSpectrumMethod() const -> ResponseSpectrumMethod;
+  void setResponseSpectrumMethod(ResponseSpectrumMethod method);
   auto isLoaded() const -> bool;
 
   void fromJson(const QJsonObject &json);
   auto toJson() const -> QJsonObject;
 
+  //! Also saves the spectral acceleration to the motion cache
+  void setRespSpecSa(const QVector<double> &sa);
+
 signals:
   void fileNameChanged(QString fileName);
   void timeStepChanged(double timeStep);
@@ -204,6 +217,23 @@ protected:
   //! Call the readFile and computeSpecAccel functions
   void processFile(std::ifstream *);
 
+  /*! Compute the response spectrum from the inverse FFT of each oscillator.
+   * The Fourier amplitudes are zero padded so that the oscillator response
+   * is sampled at least ten times per period.
+   */
+  auto computeSaFrequencyDomain(const QVector<double> &period, double damping,
+                                const QVector<std::complex<double>> &accelTf)
+      const -> QVector<double>;
+
+  /*! Compute the response spectrum by integrating the oscillators in time.
+   * The acceleration time series is computed once, and then all oscillators
+   * are stepped together using the exact solution for piecewise-linear
+   * excitation. Oscillators are substepped to at least ten steps per period.
+   */
+  auto computeSaTimeDomain(const QVector<double> &period, double damping,
+                           const QVector<std::complex<double>> &accelTf) const
+      -> QVector<double>;
+
   //! Find the maximum absolute value of a vector
   auto findMaxAbs(const QVector<double> &vector) const -> double;
 
@@ -234,13 +264,35 @@ protected:
 
   //! Compute the time series by applying a transfer function to a specified
   //! Fourier amplitude spectrum
-  auto calcTimeSeries(QVector<std::complex<double>> fa,
+  auto calcTimeSeries(const QVector<std::complex<double>> &fa,
                       const QVector<std::complex<double>> &tf) const
       -> QVector<double>;
 
+  //! Compute the time series into \a ts, reusing its storage
+  void calcTimeSeries(const QVector<std::complex<double>> &fa,
+                      const QVector<std::complex<double>> &tf,
+                      QVector<double> &ts) const;
+
   //! The conversion factor for the input motion
   auto unitConversionFactor() const -> double;
 
+  //! Compute the frequencies of the Fourier amplitude spectrum
+  void calculateFreq();
+
+  //! Serialized settings that change the values loaded from the file
+  auto cacheSettings() const -> QByteArray;
+
+  /*! Load the file through the MotionCache.
+   *
+   * The file is only read and processed if the cache does not have an entry
+   * for its contents and settings.
+   */
+  void loadCached();
+
+  //! Save the response spectrum to the cache entry that the motion was loaded
+  //! from, if the motion has not changed since
+  void saveCachedRespSpec();
+
   //! Columns for the data view
   enum Column { TimeColumn, AccelColumn };
 
@@ -286,7 +338,15 @@ protected:
   //! If the acceleration data should be saved
   bool _saveData;
 
+  //! Method used to compute the response spectrum
+  ResponseSpectrumMethod _responseSpectrumMethod;
+
   //! If the motion has been loaded from the file
   bool _isLoaded;
+
+  //! Key of the cache entry without a response spectrum that the motion was
+  //! loaded from, and the settings after loading
+  QByteArray _cacheKey;
+  QByteArray _cacheSettings;
 };
 #endif
@@ -25,13 +25,26 @@
 
 #include <gsl/gsl_errno.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
 VanmarckePeakCalculator::VanmarckePeakCalculator() {
   _name = "Vanmarcke (1975)";
-  _workspace = gsl_integration_workspace_alloc(4000);
+  _peakFactorMethod = Integration;
+}
+
+VanmarckePeakCalculator::~VanmarckePeakCalculator() {}
+
+auto VanmarckePeakCalculator::peakFactorMethod() const -> PeakFactorMethod {
+  return _peakFactorMethod;
 }
 
-VanmarckePeakCalculator::~VanmarckePeakCalculator() {
-  gsl_integration_workspace_free(_workspace);
+void VanmarckePeakCalculator::setPeakFactorMethod(PeakFactorMethod method) {
+  _peakFactorMethod = method;
 }
 
 struct ccdfParams {
@@ -47,20 +60,240 @@ auto calcCCDF(double x, void *params) -> double {
                       (exp((x * x) / 2) - 1)));
 }
 
+namespace {
+/*! Table of the peak factor integral.
+ *
+ * The table is evenly spaced in the log of the number of zero crossings, u,
+ * and in t = sqrt(ln(1 + n b) / ln(1 + n)), where n is the number of zero
+ * crossings and b is the effective bandwidth. For small bandwidths the peak
+ * factor depends on the product n b, and is not smooth in b as it
+ * approaches zero, which t accounts for. Values are interpolated with bicubic
+ * (Catmull-Rom) interpolation, and the nodes beyond the edges are
+ * extrapolated with a quadratic. Compared to the integral, the relative
+ * error is less than 1e-4, which is checked by test/peak_factor_table.cpp.
+ */
+class PeakFactorTable {
+public:
+  static constexpr int lnZeroCrossingsCount = 64;
+  static constexpr int bandwidthCount = 61;
+
+  PeakFactorTable() : _values(lnZeroCrossingsCount * bandwidthCount) {
+    for (int i = 0; i < lnZeroCrossingsCount; ++i) {
+      for (int j = 0; j < bandwidthCount; ++j) {
+        double zeroCrossings, bandwidthEff;
+        point(i, j, &zeroCrossings, &bandwidthEff);
+        _values[i * bandwidthCount + j] =
+            VanmarckePeakCalculator::integratePeakFactor(zeroCrossings,
+                                                         bandwidthEff, 1e-6);
+      }
+    }
+  }
+
+  //! Zero crossings and effective bandwidth at fractional indices u and v
+  static void point(double u, double v, double *zeroCrossings,
+                    double *bandwidthEff) {
+    *zeroCrossings = exp(lnZeroCrossingsMin + u * lnZeroCrossingsDelta());
+    const double t = v / (bandwidthCount - 1);
+    *bandwidthEff = std::min(
+        1., expm1(t * t * log1p(*zeroCrossings)) / *zeroCrossings);
+  }
+
+  //! Interpolate the peak factor, returns false if outside of the table
+  auto interp(double zeroCrossings, double bandwidthEff,
+              double *peakFactor) const -> bool {
+    const double u =
+        (log(zeroCrossings) - lnZeroCrossingsMin) / lnZeroCrossingsDelta();
+    const double v =
+        sqrt(log1p(zeroCrossings * std::max(0., bandwidthEff)) /
+             log1p(zeroCrossings)) *
+        (bandwidthCount - 1);
+
+    if (u < 0 || u > lnZeroCrossingsCount - 1 || v > bandwidthCount - 1)
+      return false;
+
+    const int i = std::min(int(u), lnZeroCrossingsCount - 2);
+    const int j = std::min(int(v), bandwidthCount - 2);
+
+    double rows[4];
+    for (int k = 0; k < 4; ++k) {
+      rows[k] = cubic(at(i - 1 + k, j - 1), at(i - 1 + k, j),
+                      at(i - 1 + k, j + 1), at(i - 1 + k, j + 2), v - j);
+    }
+
+    *peakFactor = cubic(rows[0], rows[1], rows[2], rows[3], u - i);
+    return true;
+  }
+
+private:
+  // Zero crossings are limited to at least 1.33
+  static constexpr double lnZeroCrossingsMin = 0.28517894223366247;
+  // Covers up to 1e5 zero crossings
+  static constexpr double lnZeroCrossingsMax = 11.512925464970229;
+
+  static constexpr auto lnZeroCrossingsDelta() -> double {
+    return (lnZeroCrossingsMax - lnZeroCrossingsMin) /
+           (lnZeroCrossingsCount - 1);
+  }
+
+  //! Catmull-Rom interpolation between p1 and p2
+  static auto cubic(double p0, double p1, double p2, double p3, double t)
+      -> double {
+    return p1 + 0.5 * t *
+                    (p2 - p0 +
+                     t * (2 * p0 - 5 * p1 + 4 * p2 - p3 +
+                          t * (3 * (p1 - p2) + p3 - p0)));
+  }
+
+  //! Value at a bandwidth node, extrapolated beyond the edges
+  auto atBandwidth(int i, int j) const -> double {
+    const double *row = _values.data() + i * bandwidthCount;
+    if (j < 0)
+      return 3 * row[0] - 3 * row[1] + row[2];
+    if (j >= bandwidthCount) {
+      const int n = bandwidthCount;
+      return 3 * row[n - 1] - 3 * row[n - 2] + row[n - 3];
+    }
+    return row[j];
+  }
+
+  //! Value at a node, extrapolated beyond the edges
+  auto at(int i, int j) const -> double {
+    if (i < 0)
+      return 3 * atBandwidth(0, j) - 3 * atBandwidth(1, j) +
+             atBandwidth(2, j);
+    if (i >= lnZeroCrossingsCount) {
+      const int n = lnZeroCrossingsCount;
+      return 3 * atBandwidth(n - 1, j) - 3 * atBandwidth(n - 2, j) +
+             atBandwidth(n - 3, j);
+    }
+    return atBandwidth(i, j);
+  }
+
+  std::vector<double> _values;
+};
+
+//! Integration workspace, one per thread so that the peak factors of
+//! oscillators can be computed in parallel
+class IntegrationWorkspace {
+public:
+  IntegrationWorkspace() : _workspace(gsl_integration_workspace_alloc(4000)) {}
+  ~IntegrationWorkspace() { gsl_integration_workspace_free(_workspace); }
+
+  auto get() const -> gsl_integration_workspace * { return _workspace; }
+
+private:
+  gsl_integration_workspace *_workspace;
+};
+
+//! Set while a thread integrates a peak factor
+thread_local bool integrating = false;
+
+//! GSL error handler that was installed before integrationErrorHandler
+gsl_error_handler_t *previousErrorHandler = nullptr;
+
+/*! GSL error handler that ignores the errors of the peak factor integration.
+ *
+ * Those errors are handled with the returned status. Any other error is
+ * passed to the previous handler, or handled as by the default GSL handler,
+ * which aborts.
+ */
+void integrationErrorHandler(const char *reason, const char *file, int line,
+                             int gslErrno) {
+  if (integrating) {
+    return;
+  }
+
+  if (previousErrorHandler) {
+    previousErrorHandler(reason, file, line, gslErrno);
+    return;
+  }
+
+  gsl_stream_printf("ERROR", file, line, reason);
+  fflush(stdout);
+  fprintf(stderr, "Default GSL error handler invoked.\n");
+  fflush(stderr);
+  abort();
+}
+
+/*! Integrate with gsl_integration_qagiu(), reporting errors only through
+ * the returned status.
+ *
+ * The GSL error handler is shared by the whole process, so instead of being
+ * switched off around the integration, a handler that checks the calling
+ * thread is installed once.
+ */
+auto integrateQagiu(gsl_function *f, double epsabs, double epsrel,
+                    size_t limit, gsl_integration_workspace *workspace,
+                    double *result, double *abserr) -> int {
+  static std::once_flag installed;
+  std::call_once(installed, []() {
+    previousErrorHandler = gsl_set_error_handler(&integrationErrorHandler);
+  });
+
+  integrating = true;
+  const int status = gsl_integration_qagiu(f, 0, epsabs, epsrel, limit,
+                                           workspace, result, abserr);
+  integrating = false;
+  return status;
+}
+
+//! Table shared by all calculators, computed on first use
+auto peakFactorTable() -> const PeakFactorTable & {
+  static const PeakFactorTable table;
+  return table;
+}
+} // namespace
+
 auto VanmarckePeakCalculator::calcPeakFactor(double duration, double oscFreq,
-                                             double oscDamping) -> double {
+                                             double oscDamping,
+                                             const Moments &moments) const
+    -> double {
   Q_UNUSED(oscFreq);
   Q_UNUSED(oscDamping);
 
   // Compute the root - mean - squared response
-  double m0 = getMoment(0);
-  double m1 = getMoment(1);
-  double m2 = getMoment(2);
+  double m0 = moments.m0;
+  double m1 = moments.m1;
+  double m2 = moments.m2;
 
   double bandwidth = sqrt(1 - (m1 * m1) / (m0 * m2));
   double bandwidthEff = pow(bandwidth, 1.2);
 
   double zeroCrossings = limitZeroCrossings(duration * sqrt(m2 / m0) * M_1_PI);
+
+  double peakFactor;
+  if (_peakFactorMethod == Tabulated &&
+      tabulatedPeakFactor(zeroCrossings, bandwidthEff, &peakFactor)) {
+    return peakFactor;
+  }
+
+  return integratePeakFactor(zeroCrossings, bandwidthEff);
+}
+
+auto VanmarckePeakCalculator::tabulatedPeakFactor(double zeroCrossings,
+                                                  double bandwidthEff,
+                                                  double *peakFactor)
+    -> bool {
+  return peakFactorTable().interp(zeroCrossings, bandwidthEff, peakFactor);
+}
+
+void VanmarckePeakCalculator::peakFactorTableSize(int *zeroCrossingsCount,
+                                                  int *bandwidthCount) {
+  *zeroCrossingsCount = PeakFactorTable::lnZeroCrossingsCount;
+  *bandwidthCount = PeakFactorTable::bandwidthCount;
+}
+
+void VanmarckePeakCalculator::peakFactorTablePoint(double u, double v,
+                                                   double *zeroCrossings,
+                                                   double *bandwidthEff) {
+  PeakFactorTable::point(u, v, zeroCrossings, bandwidthEff);
+}
+
+auto VanmarckePeakCalculator::integratePeakFactor(double zeroCrossings,
+                                                  double bandwidthEff,
+                                                  double tolerance) -> double {
+  thread_local IntegrationWorkspace workspace;
+
   // The expected peak factor is computed as the integral of the complementary
   // CDF(1 - CDF(x)).
   double peakFactor, error;
@@ -70,14 +303,9 @@ auto VanmarckePeakCalculator::calcPeakFactor(double duration, double oscFreq,
   F.function = &calcCCDF;
   F.params = &params;
 
-  // Disable the default GSL error handler to prevent abort on integration
-  // difficulties
-  gsl_error_handler_t *oldHandler = gsl_set_error_handler_off();
-
-  int status = gsl_integration_qagiu(&F, 0, 1e-4, 1e-4, 4000, _workspace,
-                                     &peakFactor, &error);
-
-  gsl_set_error_handler(oldHandler);
+  // Integration difficulties are reported by the status
+  int status = integrateQagiu(&F, tolerance, tolerance, 4000, workspace.get(),
+                              &peakFactor, &error);
 
   if (status && peakFactor <= 0) {
     peakFactor = 2.5;
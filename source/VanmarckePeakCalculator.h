@@ -31,11 +31,38 @@ public:
   explicit VanmarckePeakCalculator();
   ~VanmarckePeakCalculator();
 
+  //! Method used to compute the expected peak factor
+  enum PeakFactorMethod {
+    Integration, //!< Adaptive integration of the complementary CDF
+    Tabulated    //!< Interpolation of a precomputed table of the integral
+  };
+
+  auto peakFactorMethod() const -> PeakFactorMethod;
+  void setPeakFactorMethod(PeakFactorMethod method);
+
+  //! Peak factor from the integral of the complementary CDF
+  static auto integratePeakFactor(double zeroCrossings, double bandwidthEff,
+                                  double tolerance = 1e-4) -> double;
+
+  //! Peak factor interpolated from the table, returns false if outside of the
+  //! table
+  static auto tabulatedPeakFactor(double zeroCrossings, double bandwidthEff,
+                                  double *peakFactor) -> bool;
+
+  //! Number of nodes in the table
+  static void peakFactorTableSize(int *zeroCrossingsCount,
+                                  int *bandwidthCount);
+
+  //! Zero crossings and effective bandwidth at fractional indices of the
+  //! table
+  static void peakFactorTablePoint(double u, double v, double *zeroCrossings,
+                                   double *bandwidthEff);
+
 protected:
-  auto calcPeakFactor(double duration, double oscFreq, double oscDamping)
-      -> double;
+  auto calcPeakFactor(double duration, double oscFreq, double oscDamping,
+                      const Moments &moments) const -> double;
 
-  gsl_integration_workspace *_workspace;
+  PeakFactorMethod _peakFactorMethod;
 };
 
 #endif // VANMARCKEPEAKCALCULATOR_H
@@ -32,7 +32,7 @@ WangRathjePeakCalculator::WangRathjePeakCalculator() {
 
 auto WangRathjePeakCalculator::calcDurationRms(
     double duration, double oscFreq, double oscDamping,
-    const QVector<std::complex<double>> &siteTransFunc) -> double {
+    const QVector<std::complex<double>> &siteTransFunc) const -> double {
   // Compute the Boore & Thompson (2015) correction for oscillator response
   double durationRms = BooreThompsonPeakCalculator::calcDurationRms(
       duration, oscFreq, oscDamping, siteTransFunc);
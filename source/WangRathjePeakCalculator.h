@@ -40,7 +40,8 @@ public:
 
   virtual auto
   calcDurationRms(double duration, double oscFreq, double oscDamping,
-                  const QVector<std::complex<double>> &siteTransFunc) -> double;
+                  const QVector<std::complex<double>> &siteTransFunc) const
+      -> double;
 
 protected:
   QList<WangRathjeCoef> _coefs;
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Compare the strain profiles computed with and without incremental updates.
+
+Usage:
+    compare_incremental.py <strata_binary> <example.json> [...] [--rtol=2e-2]
+
+Each example is run twice in batch mode, once recomputing every sublayer in
+each iteration and once skipping the settled sublayers. The error tolerance
+of both runs is reduced, so that the maximum strain profiles of the two runs
+must agree within the relative tolerance.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Error tolerance of the iterations in percent, the minimum of the GUI
+ERROR_TOLERANCE = 0.5
+MAX_ITERATIONS = 30
+
+
+def run(strata_bin, example_path, tmpdir, incremental):
+    """Run a copy of the example and return its maximum strain profiles."""
+    with open(example_path) as f:
+        doc = json.load(f)
+
+    calculator = doc.setdefault("calculator", {})
+    calculator["errorTolerance"] = ERROR_TOLERANCE
+    calculator["maxIterations"] = MAX_ITERATIONS
+    calculator["incremental"] = incremental
+
+    suffix = "incremental" if incremental else "full"
+    path = os.path.join(tmpdir, f"{suffix}-{os.path.basename(example_path)}")
+    with open(path, "w") as f:
+        json.dump(doc, f)
+
+    result = subprocess.run(
+        [strata_bin, "-b", path], capture_output=True, text=True, timeout=300
+    )
+    if result.returncode != 0:
+        raise RuntimeError(
+            f"Strata exited with code {result.returncode}: {result.stderr}"
+        )
+
+    with open(path) as f:
+        doc = json.load(f)
+
+    if not doc.get("hasResults", False):
+        raise RuntimeError("Strata did not produce results")
+
+    for entry in doc["outputCatalog"]["profilesOutputCatalog"]:
+        if entry.get("className") == "MaxStrainProfileOutput":
+            return entry["data"]
+
+    raise RuntimeError("No maximum strain profile in the results")
+
+
+def compare(full, incremental, rtol):
+    """Return the largest relative difference and the number of failures."""
+    if len(full) != len(incremental):
+        raise ValueError("Different numbers of sites")
+
+    max_rel = 0.0
+    failures = 0
+    for full_site, inc_site in zip(full, incremental):
+        if len(full_site) != len(inc_site):
+            raise ValueError("Different numbers of motions")
+        for full_row, inc_row in zip(full_site, inc_site):
+            if len(full_row) != len(inc_row):
+                raise ValueError("Different numbers of depths")
+            for a, b in zip(full_row, inc_row):
+                rel = abs(a - b) / max(abs(a), abs(b), 1e-15)
+                max_rel = max(max_rel, rel)
+                if rel > rtol:
+                    failures += 1
+    return max_rel, failures
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare incremental and full strain iterations"
+    )
+    parser.add_argument("strata_binary", help="Path to the strata executable")
+    parser.add_argument("examples", nargs="+", help="Example JSON files")
+    parser.add_argument(
+        "--rtol",
+        type=float,
+        default=2e-2,
+        help="Relative tolerance of the strain profiles (default: 2e-2)",
+    )
+    args = parser.parse_args()
+
+    strata_bin = os.path.abspath(args.strata_binary)
+    failed = False
+
+    for example_path in args.examples:
+        name = os.path.basename(example_path)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            motions_dir = os.path.join(os.path.dirname(example_path), "motions")
+            if os.path.isdir(motions_dir):
+                shutil.copytree(motions_dir, os.path.join(tmpdir, "motions"))
+
+            try:
+                full = run(strata_bin, example_path, tmpdir, False)
+                incremental = run(strata_bin, example_path, tmpdir, True)
+                max_rel, failures = compare(full, incremental, args.rtol)
+            except (RuntimeError, ValueError, subprocess.TimeoutExpired) as e:
+                print(f"  FAIL: {name}: {e}")
+                failed = True
+                continue
+
+        status = "FAIL" if failures else "PASS"
+        print(
+            f"  {status}: {name}: maximum relative difference {max_rel:.2e}"
+            f" ({failures} values above {args.rtol})"
+        )
+        failed = failed or failures > 0
+
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
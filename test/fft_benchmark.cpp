@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Time per response spectrum of the transforms in FourierTransform, compared
+// with the previous implementation that allocated a buffer, and with FFTW
+// created a plan, for every transform. The spectra of both are checked to be
+// the same.
+
+#include "FourierTransform.h"
+
+#ifdef USE_FFTW
+#include <fftw3.h>
+#else
+#include <gsl/gsl_fft_halfcomplex.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+//! Number of points in the time series
+const int pointCount = 4096;
+const double timeStep = 0.005;
+//! Number of oscillator periods in each spectrum
+const int periodCount = 100;
+const double damping = 5.;
+
+//! Inverse transform as it was done before the workspaces and plans were
+//! reused
+void previousInverse(const std::vector<std::complex<double>> &in,
+                     std::vector<double> &out) {
+  const int n = 2 * (in.size() - 1);
+  auto *d = new double[n];
+
+  d[0] = in.front().real();
+  for (int i = 1; i < static_cast<int>(in.size()); ++i) {
+    d[i] = in.at(i).real();
+    d[n - i] = in.at(i).imag();
+  }
+  d[n / 2] = in.back().real();
+
+#ifdef USE_FFTW
+  fftw_plan p = fftw_plan_r2r_1d(n, d, d, FFTW_HC2R, FFTW_ESTIMATE);
+  fftw_execute(p);
+  fftw_destroy_plan(p);
+
+  for (int i = 0; i < n; ++i)
+    d[i] /= n;
+#else
+  gsl_fft_halfcomplex_radix2_inverse(d, 1, n);
+#endif
+
+  out.resize(n);
+  memcpy(out.data(), d, n * sizeof(double));
+  delete[] d;
+}
+
+//! Spectral acceleration with the previous implementation
+auto previousSa(const std::vector<std::complex<double>> &fa,
+                const std::vector<std::complex<double>> &tf) -> double {
+  // The Fourier amplitudes were copied and modified
+  std::vector<std::complex<double>> copy(fa);
+  for (size_t i = 0; i < copy.size(); ++i)
+    copy[i] *= tf.at(i);
+
+  std::vector<double> ts;
+  previousInverse(copy, ts);
+
+  double max = 0;
+  for (double v : ts)
+    max = std::max(max, std::fabs(v));
+  return max;
+}
+
+//! Spectral acceleration with the workspace, as in
+//! TimeSeriesMotion::calcTimeSeries()
+auto currentSa(const std::vector<std::complex<double>> &fa,
+               const std::vector<std::complex<double>> &tf,
+               std::vector<double> &ts) -> double {
+  const int n = 2 * (fa.size() - 1);
+  double *d = FourierTransform::workspace(n);
+  for (int i = 0; i <= n / 2; ++i) {
+    const std::complex<double> c = fa.at(i) * tf.at(i);
+    d[i] = c.real();
+    if (0 < i && i < n / 2)
+      d[n - i] = c.imag();
+  }
+
+  FourierTransform::inverse(n);
+
+  ts.resize(n);
+  memcpy(ts.data(), d, n * sizeof(double));
+
+  double max = 0;
+  for (double v : ts)
+    max = std::max(max, std::fabs(v));
+  return max;
+}
+
+//! Time per spectrum in microseconds, the fastest of several repetitions to
+//! reduce the effect of other processes
+template <typename F> auto timeSpectra(F computeSpectrum) -> double {
+  const int repetitions = 10;
+  const int count = 10;
+
+  double fastest = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+      computeSpectrum();
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (!r || elapsed.count() / count < fastest)
+      fastest = elapsed.count() / count;
+  }
+  return fastest;
+}
+} // namespace
+
+auto main() -> int {
+  // Synthetic acceleration: a decaying sum of sines
+  double *d = FourierTransform::workspace(pointCount);
+  for (int i = 0; i < pointCount; ++i) {
+    const double t = i * timeStep;
+    d[i] = std::exp(-0.2 * t) *
+           (std::sin(2 * M_PI * 1.3 * t) + 0.5 * std::sin(2 * M_PI * 7.1 * t) +
+            0.2 * std::sin(2 * M_PI * 17.9 * t));
+  }
+  FourierTransform::forward(pointCount);
+
+  std::vector<std::complex<double>> fa(pointCount / 2 + 1);
+  fa.front() = d[0];
+  for (int i = 1; i < pointCount / 2; ++i)
+    fa[i] = std::complex<double>(d[i], d[pointCount - i]);
+  fa.back() = d[pointCount / 2];
+
+  // Transfer functions of the oscillators
+  const double freqStep = 1. / (pointCount * timeStep);
+  std::vector<std::vector<std::complex<double>>> tfs(periodCount);
+  for (int j = 0; j < periodCount; ++j) {
+    const double period = 0.01 * std::pow(1000., double(j) / (periodCount - 1));
+    const double fn = 1 / period;
+    tfs[j].resize(fa.size());
+    for (size_t i = 0; i < fa.size(); ++i) {
+      const double f = i * freqStep;
+      tfs[j][i] = (-fn * fn) / std::complex<double>(f * f - fn * fn,
+                                                    -2 * (damping / 100) *
+                                                        fn * f);
+    }
+  }
+
+  std::vector<double> previous(periodCount);
+  std::vector<double> current(periodCount);
+  std::vector<double> ts;
+
+  const double previousTime = timeSpectra([&]() {
+    for (int j = 0; j < periodCount; ++j)
+      previous[j] = previousSa(fa, tfs.at(j));
+  });
+  const double currentTime = timeSpectra([&]() {
+    for (int j = 0; j < periodCount; ++j)
+      current[j] = currentSa(fa, tfs.at(j), ts);
+  });
+
+  double maxError = 0;
+  for (int j = 0; j < periodCount; ++j)
+    maxError = std::max(maxError, std::fabs(current[j] - previous[j]) /
+                                      std::fabs(previous[j]));
+
+  printf("%d points, %d periods per spectrum\n", pointCount, periodCount);
+  printf("previous: %.1f us per spectrum\n", previousTime);
+  printf("current:  %.1f us per spectrum\n", currentTime);
+  printf("maximum relative difference of Sa: %.3g\n", maxError);
+
+  return maxError < 1e-12 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of Strata.
+//
+// Strata is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Strata is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Strata.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2010-2018 Albert Kottke
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Checks the tabulated peak factors of VanmarckePeakCalculator against the
+// integral, at the nodes of the table and between them.
+
+#include "VanmarckePeakCalculator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+auto main() -> int {
+  // Tolerance of the reference integral, which is tighter than the one used
+  // to compute the table
+  const double tolerance = 1e-8;
+  const double maxAllowed = 1e-4;
+  // Points per interval of the table
+  const int subdivisions = 4;
+
+  int zeroCrossingsCount, bandwidthCount;
+  VanmarckePeakCalculator::peakFactorTableSize(&zeroCrossingsCount,
+                                               &bandwidthCount);
+
+  double maxNodeError = 0;
+  double maxError = 0;
+  double worstZeroCrossings = 0;
+  double worstBandwidthEff = 0;
+
+  for (int a = 0; a <= (zeroCrossingsCount - 1) * subdivisions; ++a) {
+    for (int b = 0; b <= (bandwidthCount - 1) * subdivisions; ++b) {
+      double zeroCrossings, bandwidthEff;
+      VanmarckePeakCalculator::peakFactorTablePoint(
+          double(a) / subdivisions, double(b) / subdivisions, &zeroCrossings,
+          &bandwidthEff);
+
+      double tabulated;
+      if (!VanmarckePeakCalculator::tabulatedPeakFactor(
+              zeroCrossings, bandwidthEff, &tabulated)) {
+        printf("Point outside of the table: zeroCrossings=%g "
+               "bandwidthEff=%g\n",
+               zeroCrossings, bandwidthEff);
+        return 1;
+      }
+
+      const double integrated = VanmarckePeakCalculator::integratePeakFactor(
+          zeroCrossings, bandwidthEff, tolerance);
+      const double error = fabs(tabulated / integrated - 1);
+
+      if (a % subdivisions == 0 && b % subdivisions == 0) {
+        maxNodeError = std::max(maxNodeError, error);
+      } else if (error > maxError) {
+        maxError = error;
+        worstZeroCrossings = zeroCrossings;
+        worstBandwidthEff = bandwidthEff;
+      }
+    }
+  }
+
+  printf("Maximum relative error at the nodes: %.3g\n", maxNodeError);
+  printf("Maximum relative error between the nodes: %.3g "
+         "(zeroCrossings=%g bandwidthEff=%g)\n",
+         maxError, worstZeroCrossings, worstBandwidthEff);
+
+  return (maxNodeError > maxAllowed || maxError > maxAllowed) ? 1 : 0;
+}